@@ -21,14 +21,7 @@ bool Ac3::Propagate(const int _var_id) {
   Clock beg;
 
   Queue queue;
-  const vector<int>& cons = network_->constraints(_var_id);
-  for (auto it = cons.cbegin(), end = cons.cend(); it != end; ++it) {
-    const int con_id = *it;
-    const Constraint& constraint = network_->constraint(con_id);
-    assert(constraint.arity() == 2);
-    const int var_index = constraint.scope(0) == _var_id ? 1 : 0;
-    queue.push(ReviseItem(con_id, var_index));
-  }
+  Enqueue(_var_id, -1, &queue);
 
   const bool consistent = Enforce(&queue);
 
@@ -44,9 +37,10 @@ bool Ac3::Preprocess() {
   const int num_constraints = network_->num_constraints();
   for (int c = 0; c < num_constraints; ++c) {
     const Constraint& constraint = network_->constraint(c);
-    assert(constraint.arity() == 2);
     queue.push(ReviseItem(c, 0));
-    queue.push(ReviseItem(c, 1));
+    if (constraint.arity() == 2) {
+      queue.push(ReviseItem(c, 1));
+    }
   }
 
   const bool consistent = Enforce(&queue);
@@ -57,35 +51,51 @@ bool Ac3::Preprocess() {
 
 bool Ac3::Enforce(Queue* queue) {
   bool consistent = true;
+  vector<int> reduced;
   while (queue->size()) {
     ++num_iterations_;
     ReviseItem item = queue->front();
     queue->pop();
-    if (Revise(item)) {
-      const Constraint& constraint = network_->constraint(item.constraint);
+    Constraint& constraint = network_->constraint(item.constraint);
+    if (constraint.arity() != 2) {
+      // Non-binary constraints revise all scope variables at once.
+      const int num_prunings = constraint.num_prunings();
+      reduced.clear();
+      if (!constraint.Propagate(network_, &reduced)) {
+        consistent = false;
+        break;
+      }
+      num_removed_ += constraint.num_prunings() - num_prunings;
+      for (auto it = reduced.cbegin(), end = reduced.cend(); it != end; ++it) {
+        Enqueue(*it, item.constraint, queue);
+      }
+    } else if (Revise(item)) {
       const int var_id = constraint.scope(item.var_index);
       const Variable& var = network_->variable(var_id);
       if (var.domain().empty()) {
         consistent = false;
         break;
       }
-      const vector<int>& constraints = network_->constraints(var_id);
-      for (auto it = constraints.cbegin(), end = constraints.cend();
-           it != end; ++it) {
-        const int constraint_id = *it;
-        if (constraint_id != item.constraint) {
-          const Constraint& c = network_->constraint(constraint_id);
-          if (constraint.arity() == 2) {
-            const int var2_index = c.scope(0) == var_id ? 1 : 0;
-            queue->push(ReviseItem(constraint_id, var2_index));
-          }
-        }
-      }
+      Enqueue(var_id, item.constraint, queue);
     }
   }
   return consistent;
 }
 
+void Ac3::Enqueue(const int var_id, const int constraint_id, Queue* queue) {
+  const vector<int>& constraints = network_->constraints(var_id);
+  for (auto it = constraints.cbegin(), end = constraints.cend();
+       it != end; ++it) {
+    if (*it != constraint_id) {
+      // Binary constraints revise the other variable, non-binary constraints
+      // revise all.
+      const Constraint& c = network_->constraint(*it);
+      const int var_index = c.arity() == 2 && c.scope(0) == var_id ? 1 : 0;
+      queue->push(ReviseItem(*it, var_index));
+    }
+  }
+}
+
 bool Ac3::Revise(const Ac3::ReviseItem& item) {
   const Constraint& constraint = network_->constraint(item.constraint);
   assert(constraint.arity() == 2);
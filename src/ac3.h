@@ -12,6 +12,8 @@ class Network;
 class Assignment;
 
 // AC3 (Arc Consistency 3) Preprocessor. Also used for MAP iterations.
+// Non-binary constraints are revised by their tables for generalised
+// arc-consistency.
 class Ac3 : public Preprocessor {
  public:
   // Initializes preprocessor with given network.
@@ -54,6 +56,11 @@ class Ac3 : public Preprocessor {
   typedef std::queue<ReviseItem> Queue;
 
   bool Enforce(Queue* queue);
+
+  // Queues the revisions of the constraints on given variable after its domain
+  // has been reduced, except for given constraint.
+  void Enqueue(const int var_id, const int constraint_id, Queue* queue);
+
   bool Revise(const ReviseItem& item);
 
   Network* network_;
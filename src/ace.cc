@@ -1,45 +1,127 @@
 // Copyright 2012 Eugen Sawin <esawin@me73.com>
 #include <gflags/gflags.h>
 #include <cassert>
+#include <fstream>
 #include <iostream>
+#include <limits>
+#include <thread>
 #include <vector>
 #include "./parser.h"
 #include "./network.h"
 #include "./network-factory.h"
 #include "./backtrack-solver.h"
 #include "./backjump-solver.h"
+#include "./btd-solver.h"
+#include "./cycle-cutset-solver.h"
 #include "./random-walk-solver.h"
+#include "./tabu-solver.h"
+#include "./breakout-solver.h"
+#include "./max-csp-solver.h"
+#include "./portfolio-solver.h"
+#include "./parallel-backtrack-solver.h"
+#include "./eps-solver.h"
+#include "./multi-walk-solver.h"
+#include "./component-solver.h"
+#include "./solution-sink.h"
 #include "./ac3.h"
+#include "./interchangeability.h"
+#include "./clique-bound.h"
+#include "./nogood-base.h"
 #include "./clock.h"
 #include "./profiler.h"
 #include "./max-cardinality-ordering.h"
 #include "./min-width-ordering.h"
+#include "./min-fill-ordering.h"
+#include "./best-ordering.h"
+#include "./fixed-ordering.h"
 
 using std::cout;
 using std::endl;
 using std::string;
 using std::vector;
 using std::min;
+using std::ofstream;
 using base::Clock;
 using ace::parse::Parser;
 using ace::Solver;
 using ace::BacktrackSolver;
 using ace::BackjumpSolver;
+using ace::BtdSolver;
+using ace::CycleCutsetSolver;
 using ace::RandomWalkSolver;
+using ace::TabuSolver;
+using ace::BreakoutSolver;
+using ace::MaxCspSolver;
+using ace::PortfolioSolver;
+using ace::ParallelBacktrackSolver;
+using ace::EpsSolver;
+using ace::MultiWalkSolver;
+using ace::ComponentSolver;
+using ace::NogoodBase;
+using ace::SolutionSink;
+using ace::CountingSink;
+using ace::StreamSink;
+using ace::InterchangeableSink;
 
 // Flag for the automatic selection of solving procedures.
 DEFINE_bool(auto, false, "Automatic selection of solving procedures.");
 
+// Flag for the concurrent portfolio of solving procedures.
+DEFINE_bool(portfolio, false,
+            "Run several solving procedures concurrently, the first result\
+             cancels the others.");
+
+// Flags for parallel tree search.
+DEFINE_string(parallel, "none",
+              "Parallel search (none, worksteal, eps, multiwalk)");
+DEFINE_int32(threads, 0,
+             "Number of threads used for parallel solving\
+              (0 for the number of cores).");
+DEFINE_bool(components, false,
+            "Solve the connected components of the network independently,\
+             several components in parallel.");
+DEFINE_int32(epsdepth, 0,
+             "Number of variables decomposed into subproblems for the\
+              embarrassingly parallel search (0 for automatic selection).");
+
 // Flag for verbose output.
 DEFINE_bool(verbose, false, "Verbose output");
 
 // Flag for Gaschnig's backjumping algorithm.
 DEFINE_bool(backjumping, false, "Use Gaschnig's backjumping algorithm.");
 
+// Flag for backtracking on a tree decomposition.
+DEFINE_bool(btd, false,
+            "Use backtracking on a tree decomposition with good recording,\
+             built from the heuristic ordering (minwidth if unspecified).");
+
+// Flag for the cycle-cutset method.
+DEFINE_bool(cutset, false,
+            "Use the cycle-cutset method, the cutset is selected along the\
+             heuristic ordering (maxcardinality if unspecified).");
+
 // Flag and help text for random walk algorithm.
 static const std::string randomwalk_help = string("Use random walk algorithm") +
   " with given parameters MAXTRIES,MAXFLIPS,Z, where p=Z/100.";
 DEFINE_string(randomwalk, "", randomwalk_help.c_str());
+DEFINE_int32(seed, 0,
+             "Random seed for the random walk, each parallel walk i uses the\
+              seed plus i (0 for a time-based seed, fixed for parallel\
+              walks).");
+DEFINE_bool(sharebest, false,
+            "Share the best assignment among parallel random walks.");
+
+// Flags for local search, which runs until a solution is found or the time
+// limit is reached.
+DEFINE_string(localsearch, "none",
+              "Local search algorithm (none, tabu, breakout)");
+DEFINE_int32(tabutenure, TabuSolver::kDefTabuTenure,
+             "Minimum number of steps a left value remains tabu.");
+
+// Flag for Max-CSP optimisation.
+DEFINE_bool(maxcsp, false,
+            "Search for the assignment violating the fewest constraints,\
+             improving assignments are passed to the solution sink.");
 
 // Flag for consistency preprocessing.
 DEFINE_string(consistency, "ac3",
@@ -48,7 +130,35 @@ DEFINE_string(consistency, "ac3",
 // Flag for variable ordering heuristic.
 DEFINE_string(heuristic, "unspecified",
               "Variable selection heuristic\
-               (unspecified, minwidth, maxcardinality)");
+               (unspecified, minwidth, maxcardinality, minfill, best)");
+
+// Flags for restarts with nogood recording.
+DEFINE_int32(restarts, 0,
+             "Number of backtracks before the first restart of the search,\
+              grows geometrically (0 disables restarts).");
+DEFINE_int32(nogoodlimit, NogoodBase::kDefMaxNumLiterals,
+             "Maximum number of literals stored in the nogood base\
+              (0 for unlimited).");
+
+// Flag for the all-different propagation of not-equal cliques.
+DEFINE_bool(alldiff, true,
+            "Propagate the all-different constraints implied by cliques of\
+             not-equal constraints by bipartite matching.");
+
+// Flag for breaking the symmetry of interchangeable values.
+DEFINE_bool(symmetry, true,
+            "Break the symmetry of fully interchangeable values during search\
+             for a single solution.");
+
+// Flag for the clique lower bound preprocessing.
+DEFINE_bool(cliquebound, true,
+            "Prove unsatisfiability by cliques of not-equal constraints with\
+             more variables than values before consistency preprocessing.");
+
+// Flag for merging neighbourhood interchangeable values.
+DEFINE_bool(interchangeability, false,
+            "Merge neighbourhood interchangeable values for search and expand\
+             them in the streamed solutions (not used with -components).");
 
 // Flag for execution time limit.
 DEFINE_int64(timelimit, Solver::kDefTimeLimit * Clock::kSecInMicro,
@@ -58,6 +168,11 @@ DEFINE_int64(timelimit, Solver::kDefTimeLimit * Clock::kSecInMicro,
 DEFINE_int32(maxnumsolutions, 1,
              "Maximum number of solutions to be found (0 for unlimited).");
 
+// Flag for streaming the solutions instead of storing them.
+DEFINE_string(solutionsink, "",
+              "Stream the solutions instead of storing them (count to only\
+               count them, stdout or an output file path).");
+
 // The command-line usage text.
 static const string kUsage =  // NOLINT
   string("Usage:\n") +
@@ -73,9 +188,30 @@ void Main(const string& input_path);
 // Returns whether the network was found to be consistent.
 bool Preprocess(Preprocessor* pre, Clock::Diff* duration);
 
-// Selects a solver based on provided flags.
+// Selects a solver based on provided flags, using the given variable ordering
+// if provided.
 // Returns the solver when successful, nullptr otherwise.
-Solver* SelectSolver(Network* network);
+Solver* SelectSolver(Network* network, const VariableOrdering* var_ordering);
+
+// Creates the portfolio of concurrent solving procedures.
+Solver* SelectPortfolio(const Network& network);
+
+// Creates the variable ordering based on provided flags.
+// Returns the ordering when requested, nullptr for the lexicographic ordering.
+VariableOrdering* SelectOrdering(const Network& network);
+
+// Returns the number of threads to be used for parallel solving.
+int NumThreads();
+
+// Creates the solution sink based on provided flags, writing to the given file
+// stream if requested.
+// Returns the sink when requested, nullptr otherwise.
+SolutionSink* SelectSolutionSink(const Network& network, ofstream* file);
+
+// Outputs the result of a successful search.
+// Outputs the last solution found by the solver, or the number of solutions
+// for streamed solutions, counted by the given sink if provided.
+void OutputSat(const Solver& solver, const SolutionSink* sink);
 
 }  // namespace ace
 
@@ -106,11 +242,17 @@ void Main(const string& input_path) {
   Parser parser(input_path);
   Instance instance = parser.ParseInstance();
   NetworkFactory factory;
+  // Max-CSP counts the violations of each constraint.
+  factory.merge_constraints(!FLAGS_maxcsp);
   Profiler::Start("log/network-factory.prof");
   Network network = factory.Create(instance);
   Profiler::Stop();
   // Gaschnig's backjumping overrides consistency options.
-  if (FLAGS_backjumping || FLAGS_randomwalk.size()) {
+  if (!FLAGS_portfolio && (FLAGS_backjumping || FLAGS_randomwalk.size())) {
+    FLAGS_consistency = "none";
+  }
+  // Max-CSP needs the values removed by consistency preprocessing.
+  if (FLAGS_maxcsp) {
     FLAGS_consistency = "none";
   }
   if (FLAGS_auto) {
@@ -127,6 +269,16 @@ void Main(const string& input_path) {
 
   bool consistent = true;
   Clock::Diff preprocess_time = 0;
+  // Clique lower bound.
+  if (FLAGS_cliquebound && !FLAGS_maxcsp) {
+    CliqueBound pre(network);
+    Clock::Diff duration = 0;
+    consistent = Preprocess(&pre, &duration);
+    preprocess_time += duration;
+    if (FLAGS_verbose) {
+      cout << "Clique size: " << pre.clique().size() << "\n";
+    }
+  }
   // Consistency preprocessing.
   if (consistent && FLAGS_consistency.find("ac3") != string::npos) {
     Ac3 pre(&network);
@@ -134,13 +286,68 @@ void Main(const string& input_path) {
     consistent = Preprocess(&pre, &duration);
     preprocess_time += duration;
   }
+  // Neighbourhood interchangeability preprocessing, the components are solved
+  // on separate networks.
+  Interchangeability interchangeability(&network);
+  bool merged = false;
+  if (consistent && FLAGS_interchangeability && !FLAGS_components) {
+    Clock::Diff duration = 0;
+    consistent = Preprocess(&interchangeability, &duration);
+    preprocess_time += duration;
+    merged = interchangeability.num_processed() > 0;
+    if (merged) {
+      // The merged domains are no longer symmetric.
+      FLAGS_symmetry = false;
+    }
+  }
+  // The variable ordering is created once, for the solver and the stats.
+  Clock::Diff ordering_time = 0;
+  vector<int> ordering;
+  const VariableOrdering* var_ordering = nullptr;
+  if (consistent) {
+    const Clock ordering_beg;
+    const VariableOrdering* heuristic = SelectOrdering(network);
+    if (heuristic) {
+      ordering = heuristic->CreateOrdering();
+      var_ordering = new FixedOrdering(ordering);
+      delete heuristic;
+    } else {
+      for (int i = 0; i < network.num_variables(); ++i) {
+        ordering.push_back(i);
+      }
+    }
+    ordering_time = Clock() - ordering_beg;
+  }
+  if (consistent && FLAGS_verbose) {
+    // Width of the primal graph along the variable ordering.
+    cout << "Induced width: "
+         << VariableOrdering::InducedWidth(network, ordering) << "\n"
+         << "All-different constraints: " << network.all_different().size()
+         << "\nInterchangeable values: "
+         << (network.interchangeable_values() ? "yes" : "no") << "\n";
+  }
   Clock::Diff solver_time = 0;
-  Solver* const solver = SelectSolver(&network);
+  Solver* const solver = SelectSolver(&network, var_ordering);
+  ofstream sink_file;
+  SolutionSink* const sink = SelectSolutionSink(network, &sink_file);
+  // Expands the solutions of the merged network for the requested sink.
+  const int64_t max_num_solutions = FLAGS_maxnumsolutions > 0 ?
+    FLAGS_maxnumsolutions : std::numeric_limits<int64_t>::max();
+  SolutionSink* const expanding_sink = sink && merged ?
+    new InterchangeableSink(interchangeability, max_num_solutions, sink) :
+    nullptr;
   bool sat = false;
-  if (solver) {
+  const bool searched = solver && consistent;
+  if (searched) {
     // Solve.
+    solver->solution_sink(expanding_sink ? expanding_sink : sink);
     solver->time_limit(FLAGS_timelimit * Clock::kMicroInSec - (Clock() - beg));
     solver->max_num_solutions(FLAGS_maxnumsolutions);
+    if (dynamic_cast<MaxCspSolver*>(solver)) {
+      // Stop at the known optimum.
+      static_cast<MaxCspSolver*>(solver)->target(
+        instance.min_violated_constraints);
+    }
     Profiler::Start("log/solve.prof");
     sat = solver->Solve();
     Profiler::Stop();
@@ -153,16 +360,28 @@ void Main(const string& input_path) {
     cout << "UNSAT\n";
   } else if (!solver) {
     cout << "INVALID FLAGS\n";
+  } else if (dynamic_cast<MaxCspSolver*>(solver)) {
+    // The best assignment found, unless interrupted before the first one.
+    const MaxCspSolver* max_csp_solver = static_cast<MaxCspSolver*>(solver);
+    if (sat) {
+      cout << (max_csp_solver->optimal() ? "OPTIMUM " : "BEST ")
+           << max_csp_solver->best_num_violated() << "\n"
+           << solver->solutions().back().Str() << "\n";
+    } else {
+      cout << "INDETERMINATE\n";
+    }
   } else if (sat) {
-    cout << "SAT\n"
-         << solver->solutions().back().Str() << "\n";
-  } else if (solver_time >= solver->time_limit()) {
+    OutputSat(*solver, sink);
+  } else if (!solver->complete()) {
+    // Incomplete searches can not prove unsatisfiability.
+    cout << "INDETERMINATE\n";
+  } else if (dynamic_cast<BacktrackSolver*>(solver) &&
+             solver_time >= solver->time_limit()) {
     MaxCardinalityOrdering var_ordering(network);
     BacktrackSolver* backtrack_solver = static_cast<BacktrackSolver*>(solver);
     backtrack_solver->variable_ordering(var_ordering);
     if (backtrack_solver->Solve()) {
-      cout << "SAT\n"
-           << solver->solutions().back().Str() << "\n";
+      OutputSat(*solver, sink);
     } else {
       solver_time = solver->duration();
       cout << (solver_time > solver->time_limit() ? "INDETERMINATE\n" :
@@ -172,19 +391,114 @@ void Main(const string& input_path) {
     cout << (solver_time > solver->time_limit() ? "INDETERMINATE\n" :
                                                   "UNSAT\n");
   }
-  if (consistent && FLAGS_randomwalk.size()) {
+  if (searched && FLAGS_verbose && dynamic_cast<PortfolioSolver*>(solver)) {
+    // Winner of the portfolio.
+    PortfolioSolver* portfolio = static_cast<PortfolioSolver*>(solver);
+    cout << "\nPortfolio strategies: " << portfolio->num_strategies()
+         << "\nPortfolio winner: " << (portfolio->winner().size() ?
+                                       portfolio->winner() : "none");
+  }
+  if (searched && FLAGS_verbose &&
+      dynamic_cast<ParallelBacktrackSolver*>(solver)) {
+    // Work-stealing stats.
+    ParallelBacktrackSolver* parallel_solver =
+      static_cast<ParallelBacktrackSolver*>(solver);
+    cout << "\nThreads: " << parallel_solver->num_workers()
+         << "\nSteals: " << parallel_solver->num_steals();
+  }
+  if (searched && FLAGS_verbose && dynamic_cast<EpsSolver*>(solver)) {
+    // Decomposition stats.
+    EpsSolver* eps_solver = static_cast<EpsSolver*>(solver);
+    cout << "\nThreads: " << eps_solver->num_workers()
+         << "\nDecomposition depth: " << eps_solver->decomposition_depth()
+         << "\nSubproblems: " << eps_solver->num_subproblems();
+  }
+  if (searched && FLAGS_components && FLAGS_verbose &&
+      dynamic_cast<ComponentSolver*>(solver)) {
+    // Component stats.
+    ComponentSolver* component_solver = static_cast<ComponentSolver*>(solver);
+    cout << "\nThreads: " << component_solver->num_workers()
+         << "\nComponents: " << component_solver->num_components()
+         << "\nLargest component: " << component_solver->max_component_size()
+         << "\nSolution count: " << component_solver->solution_count();
+  }
+  if (searched && FLAGS_verbose && dynamic_cast<MultiWalkSolver*>(solver)) {
+    // Multi-walk stats.
+    MultiWalkSolver* multi_walk_solver = static_cast<MultiWalkSolver*>(solver);
+    cout << "\nThreads: " << multi_walk_solver->num_walkers()
+         << "\nWinner walk: " << multi_walk_solver->winner()
+         << "\nRandom steps: " << multi_walk_solver->num_random_steps()
+         << "\nGreedy steps: " << multi_walk_solver->num_greedy_steps();
+  } else if (searched && FLAGS_verbose && dynamic_cast<BtdSolver*>(solver)) {
+    // Tree decomposition stats.
+    BtdSolver* btd_solver = static_cast<BtdSolver*>(solver);
+    cout << "\nClusters: " << btd_solver->num_clusters()
+         << "\nWidth: " << btd_solver->width()
+         << "\nGoods: " << btd_solver->num_goods()
+         << "\nNogoods: " << btd_solver->num_nogoods()
+         << "\nGood hits: " << btd_solver->num_good_hits()
+         << "\nExplored: " << solver->num_explored_states()
+         << "\nBacktracks: " << solver->num_backtracks();
+  } else if (searched && FLAGS_verbose &&
+             dynamic_cast<CycleCutsetSolver*>(solver)) {
+    // Cycle-cutset stats.
+    CycleCutsetSolver* cutset_solver = static_cast<CycleCutsetSolver*>(solver);
+    cout << "\nCutset size: " << cutset_solver->cutset_size()
+         << "\nForest solves: " << cutset_solver->num_forest_solves()
+         << "\nExplored: " << solver->num_explored_states()
+         << "\nBacktracks: " << solver->num_backtracks();
+  } else if (searched && FLAGS_verbose &&
+             dynamic_cast<MaxCspSolver*>(solver)) {
+    // Branch and bound stats.
+    MaxCspSolver* max_csp_solver = static_cast<MaxCspSolver*>(solver);
+    cout << "\nImprovements: " << max_csp_solver->num_improvements()
+         << "\nExplored: " << solver->num_explored_states()
+         << "\nBacktracks: " << solver->num_backtracks();
+  } else if (searched && FLAGS_randomwalk.size() &&
+             dynamic_cast<RandomWalkSolver*>(solver)) {
     // Exploration stats of the random walk.
     RandomWalkSolver* random_walk_solver =
       static_cast<RandomWalkSolver*>(solver);
     cout << "\nRandom steps: " << random_walk_solver->num_random_steps()
          << "\nGreedy steps: " << random_walk_solver->num_greedy_steps();
-  } else if (consistent && FLAGS_verbose) {
+  } else if (searched && FLAGS_verbose && dynamic_cast<TabuSolver*>(solver)) {
+    // Exploration stats of the tabu search.
+    TabuSolver* tabu_solver = static_cast<TabuSolver*>(solver);
+    cout << "\nSteps: " << tabu_solver->num_steps()
+         << "\nRestarts: " << tabu_solver->num_restarts()
+         << "\nBest violated: " << tabu_solver->best_num_violated();
+  } else if (searched && FLAGS_verbose &&
+             dynamic_cast<BreakoutSolver*>(solver)) {
+    // Exploration stats of the breakout method.
+    BreakoutSolver* breakout_solver = static_cast<BreakoutSolver*>(solver);
+    cout << "\nSteps: " << breakout_solver->num_steps()
+         << "\nBreakouts: " << breakout_solver->num_breakouts()
+         << "\nBest violated: " << breakout_solver->best_num_violated();
+  } else if (searched && FLAGS_verbose) {
     // Exploration stats of backtrack-based algorithms.
     double explored = solver->num_explored_states();
     cout << "\nExplored: " << explored << " of "
          <<  network.num_states()
          << " (" << explored / network.num_states() * 100.0 << "%)"
          << "\nBacktracks: " << solver->num_backtracks();
+    if (FLAGS_restarts > 0 && dynamic_cast<BacktrackSolver*>(solver)) {
+      // Restart and nogood stats.
+      BacktrackSolver* backtrack_solver = static_cast<BacktrackSolver*>(solver);
+      cout << "\nRestarts: " << backtrack_solver->num_restarts()
+           << "\nNogoods: " << backtrack_solver->num_nogoods()
+           << "\nNogood prunings: " << backtrack_solver->num_nogood_prunings();
+    }
+    if (FLAGS_alldiff && dynamic_cast<BacktrackSolver*>(solver)) {
+      BacktrackSolver* backtrack_solver = static_cast<BacktrackSolver*>(solver);
+      cout << "\nAll-different prunings: "
+           << backtrack_solver->num_all_different_prunings();
+    }
+    if (FLAGS_symmetry && network.interchangeable_values() &&
+        dynamic_cast<BacktrackSolver*>(solver)) {
+      BacktrackSolver* backtrack_solver = static_cast<BacktrackSolver*>(solver);
+      cout << "\nSymmetry prunings: "
+           << backtrack_solver->num_symmetry_prunings();
+    }
   }
   if (FLAGS_verbose) {
     const Clock::Diff parse_time = parser.duration();
@@ -192,13 +506,18 @@ void Main(const string& input_path) {
     cout << "\nParse time: " << Clock::DiffStr(parse_time)
          << "\nConstruction time: " << Clock::DiffStr(construction_time)
          << "\nPreprocess time: " << Clock::DiffStr(preprocess_time)
+         << "\nOrdering time: " << Clock::DiffStr(ordering_time)
          << "\nSolve time: " << Clock::DiffStr(solver_time)
          << "\nTotal time: " << Clock::DiffStr(parse_time + construction_time +
-                                               preprocess_time + solver_time)
+                                               preprocess_time + ordering_time +
+                                               solver_time)
          << endl;
   }
 
   delete solver;
+  delete var_ordering;
+  delete expanding_sink;
+  delete sink;
 }
 
 bool Preprocess(Preprocessor* pre, Clock::Diff* duration) {
@@ -215,13 +534,110 @@ bool Preprocess(Preprocessor* pre, Clock::Diff* duration) {
   return consistent;
 }
 
-Solver* SelectSolver(Network* network) {
+SolutionSink* SelectSolutionSink(const Network& network, ofstream* file) {
+  if (FLAGS_solutionsink.empty() || FLAGS_portfolio) {
+    // The portfolio strategies store their solutions.
+    return nullptr;
+  }
+  if (FLAGS_solutionsink == "count") {
+    return new CountingSink();
+  }
+  if (FLAGS_solutionsink == "stdout") {
+    return new StreamSink(network, &cout);
+  }
+  file->open(FLAGS_solutionsink.c_str());
+  return new StreamSink(network, file);
+}
+
+void OutputSat(const Solver& solver, const SolutionSink* sink) {
+  cout << "SAT\n";
+  if (solver.solutions().size()) {
+    cout << solver.solutions().back().Str() << "\n";
+  } else {
+    // The solutions are passed to the sink.
+    cout << "Solutions: "
+         << (sink ? sink->num_solutions() : solver.num_solutions()) << "\n";
+  }
+}
+
+Solver* SelectSolver(Network* network, const VariableOrdering* var_ordering) {
   // Choose solving algorithm.
+  if (FLAGS_portfolio && FLAGS_maxcsp) {
+    cout << "Max-CSP search is not supported by the portfolio.\n";
+    return nullptr;
+  }
+  if (FLAGS_portfolio) {
+    return SelectPortfolio(*network);
+  }
+  if ((FLAGS_maxcsp || FLAGS_cutset) && network->table_constraints().size()) {
+    cout << (FLAGS_maxcsp ? "Max-CSP" : "Cycle-cutset") <<
+            " search requires binary constraints.\n";
+    return nullptr;
+  }
+  if (FLAGS_maxcsp) {
+    // Prepare solver for Max-CSP branch and bound.
+    MaxCspSolver* max_csp_solver = new MaxCspSolver(network);
+    if (var_ordering) {
+      max_csp_solver->variable_ordering(*var_ordering);
+    }
+    return max_csp_solver;
+  }
   if (FLAGS_backjumping) {
     // Prepare solver for the basic version of Gaschnig's backjumping.
     BackjumpSolver* backjump_solver = new BackjumpSolver(network);
     return backjump_solver;
   }
+  if (FLAGS_btd && FLAGS_maxnumsolutions != 1) {
+    // Goods only keep a single extension of the separator values.
+    cout << "Tree decomposition search only finds a single solution.\n";
+    return nullptr;
+  }
+  if (FLAGS_btd) {
+    // Prepare solver for backtracking on a tree decomposition.
+    BtdSolver* btd_solver = new BtdSolver(network);
+    if (var_ordering) {
+      btd_solver->variable_ordering(*var_ordering);
+    } else {
+      btd_solver->variable_ordering(MinWidthOrdering(*network));
+    }
+    return btd_solver;
+  }
+  if (FLAGS_cutset && FLAGS_maxnumsolutions != 1) {
+    // The forest is only solved backtrack-free for the first solution.
+    cout << "Cycle-cutset search only finds a single solution.\n";
+    return nullptr;
+  }
+  if (FLAGS_cutset) {
+    // Prepare solver for the cycle-cutset method.
+    CycleCutsetSolver* cutset_solver = new CycleCutsetSolver(network);
+    if (var_ordering) {
+      cutset_solver->variable_ordering(*var_ordering);
+    }
+    return cutset_solver;
+  }
+  if (FLAGS_parallel == "multiwalk") {
+    // Prepare solver for parallel random walks.
+    vector<int> parameters;
+    if (FLAGS_randomwalk.size()) {
+      parameters = Parser::CollectInts(FLAGS_randomwalk, ",");
+      if (parameters.size() != 3) {
+        cout << "Wrong parameter size for randomwalk flag.\n";
+        return nullptr;
+      }
+    } else {
+      parameters = {std::numeric_limits<int>::max(),
+                    RandomWalkSolver::kDefMaxNumFlips,
+                    RandomWalkSolver::kDefRandomProbability};
+    }
+    MultiWalkSolver* multi_walk_solver =
+      new MultiWalkSolver(*network, NumThreads(),
+                          FLAGS_seed ? FLAGS_seed : MultiWalkSolver::kDefSeed);
+    multi_walk_solver->max_num_tries(parameters[0]);
+    multi_walk_solver->max_num_flips(parameters[1]);
+    multi_walk_solver->random_probability(parameters[2]);
+    multi_walk_solver->share_best(FLAGS_sharebest);
+    return multi_walk_solver;
+  }
   if (FLAGS_randomwalk.size()) {
     // Prepare solver for random-walk.
     const vector<int> parameters = Parser::CollectInts(FLAGS_randomwalk, ",");
@@ -230,6 +646,9 @@ Solver* SelectSolver(Network* network) {
       return nullptr;
     }
     RandomWalkSolver* random_walk_solver = new RandomWalkSolver(network);
+    if (FLAGS_seed) {
+      random_walk_solver->seed(FLAGS_seed);
+    }
     random_walk_solver->max_num_tries(parameters[0]);
     random_walk_solver->max_num_flips(parameters[1]);
     random_walk_solver->random_probability(parameters[2]);
@@ -240,17 +659,131 @@ Solver* SelectSolver(Network* network) {
     return random_walk_solver;
   }
 
+  if (FLAGS_localsearch == "tabu") {
+    // Prepare solver for tabu search.
+    TabuSolver* tabu_solver = new TabuSolver(network);
+    tabu_solver->tabu_tenure(FLAGS_tabutenure);
+    return tabu_solver;
+  } else if (FLAGS_localsearch == "breakout") {
+    // Prepare solver for the breakout method.
+    return new BreakoutSolver(network);
+  } else if (FLAGS_localsearch != "none") {
+    cout << "Unknown local search " << FLAGS_localsearch << ".\n";
+    return nullptr;
+  }
+
+  if (FLAGS_parallel == "worksteal") {
+    // Prepare solver for work-stealing backtracking with arc-consistency
+    // look-ahead.
+    ParallelBacktrackSolver* parallel_solver =
+      new ParallelBacktrackSolver(*network, NumThreads());
+    if (var_ordering) {
+      parallel_solver->variable_ordering(*var_ordering);
+    }
+    return parallel_solver;
+  } else if (FLAGS_parallel == "eps") {
+    // Prepare solver for embarrassingly parallel search over decomposed
+    // subproblems.
+    EpsSolver* eps_solver = new EpsSolver(*network, NumThreads());
+    eps_solver->decomposition_depth(FLAGS_epsdepth);
+    if (var_ordering) {
+      eps_solver->variable_ordering(*var_ordering);
+    }
+    return eps_solver;
+  } else if (FLAGS_parallel != "none") {
+    cout << "Unknown parallel search " << FLAGS_parallel << ".\n";
+    return nullptr;
+  }
+
+  if (FLAGS_components) {
+    // Prepare solver for the independent search of the connected components.
+    ComponentSolver* component_solver =
+      new ComponentSolver(*network, NumThreads());
+    component_solver->restart_cutoff(FLAGS_restarts);
+    component_solver->max_num_nogood_literals(FLAGS_nogoodlimit);
+    component_solver->all_different_propagation(FLAGS_alldiff);
+    component_solver->value_symmetry_breaking(FLAGS_symmetry);
+    if (var_ordering) {
+      component_solver->variable_ordering(*var_ordering);
+    }
+    return component_solver;
+  }
+
   // Prepare solver for backtracking with arc-consistency look-ahead.
   BacktrackSolver* backtrack_solver = new BacktrackSolver(network);
+  backtrack_solver->restart_cutoff(FLAGS_restarts);
+  backtrack_solver->max_num_nogood_literals(FLAGS_nogoodlimit);
+  backtrack_solver->all_different_propagation(FLAGS_alldiff);
+  backtrack_solver->value_symmetry_breaking(FLAGS_symmetry);
   // Choose variable ordering.
-  if (FLAGS_heuristic == "maxcardinality") {
-    MaxCardinalityOrdering var_ordering(*network);
-    backtrack_solver->variable_ordering(var_ordering);
-  } else if (FLAGS_heuristic == "minwidth") {
-    MinWidthOrdering var_ordering(*network);
-    backtrack_solver->variable_ordering(var_ordering);
+  if (var_ordering) {
+    backtrack_solver->variable_ordering(*var_ordering);
   }
   return backtrack_solver;
 }
 
+VariableOrdering* SelectOrdering(const Network& network) {
+  if (FLAGS_heuristic == "minwidth") {
+    return new MinWidthOrdering(network);
+  } else if (FLAGS_heuristic == "maxcardinality") {
+    return new MaxCardinalityOrdering(network);
+  } else if (FLAGS_heuristic == "minfill") {
+    return new MinFillOrdering(network);
+  } else if (FLAGS_heuristic == "best") {
+    return new BestOrdering(network);
+  }
+  return nullptr;
+}
+
+Solver* SelectPortfolio(const Network& network) {
+  PortfolioSolver* portfolio = new PortfolioSolver(network);
+  // Backtracking with arc-consistency look-ahead under several orderings.
+  const vector<string> heuristics = {"lexicographic", "minwidth",
+                                     "maxcardinality"};
+  for (auto it = heuristics.cbegin(), end = heuristics.cend();
+       it != end; ++it) {
+    Network* copy = portfolio->CreateNetwork();
+    BacktrackSolver* backtrack_solver = new BacktrackSolver(copy);
+    backtrack_solver->restart_cutoff(FLAGS_restarts);
+    backtrack_solver->max_num_nogood_literals(FLAGS_nogoodlimit);
+    backtrack_solver->all_different_propagation(FLAGS_alldiff);
+    backtrack_solver->value_symmetry_breaking(FLAGS_symmetry);
+    if (*it == "minwidth") {
+      backtrack_solver->variable_ordering(MinWidthOrdering(*copy));
+    } else if (*it == "maxcardinality") {
+      backtrack_solver->variable_ordering(MaxCardinalityOrdering(*copy));
+    }
+    portfolio->AddStrategy("backtrack-" + *it, backtrack_solver, true);
+  }
+  // Gaschnig's backjumping.
+  portfolio->AddStrategy("backjump",
+                         new BackjumpSolver(portfolio->CreateNetwork()), true);
+  // Random walk, which can only prove satisfiability.
+  RandomWalkSolver* random_walk_solver =
+    new RandomWalkSolver(portfolio->CreateNetwork());
+  vector<int> parameters;
+  if (FLAGS_randomwalk.size()) {
+    parameters = Parser::CollectInts(FLAGS_randomwalk, ",");
+  }
+  if (parameters.size() == 3) {
+    random_walk_solver->max_num_tries(parameters[0]);
+    random_walk_solver->max_num_flips(parameters[1]);
+    random_walk_solver->random_probability(parameters[2]);
+  } else {
+    random_walk_solver->max_num_tries(std::numeric_limits<int>::max());
+    random_walk_solver->max_num_flips(RandomWalkSolver::kDefMaxNumFlips);
+    random_walk_solver->random_probability(
+      RandomWalkSolver::kDefRandomProbability);
+  }
+  portfolio->AddStrategy("randomwalk", random_walk_solver, false);
+  return portfolio;
+}
+
+int NumThreads() {
+  if (FLAGS_threads > 0) {
+    return FLAGS_threads;
+  }
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
 }  // namespace ace
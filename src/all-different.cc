@@ -0,0 +1,202 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include "./all-different.h"
+#include <cassert>
+#include <algorithm>
+#include <map>
+#include <vector>
+#include "./network.h"
+
+using std::vector;
+using std::map;
+using std::min;
+
+namespace ace {
+
+AllDifferent::AllDifferent(const Network& network,
+                           const vector<int>& variables)
+    : variables_(variables),
+      num_values_(0),
+      num_prunings_(0) {
+  const int num_vars = variables_.size();
+  // Index the union of the variable domains.
+  map<int, int> indices;
+  value_indices_.resize(num_vars);
+  for (int i = 0; i < num_vars; ++i) {
+    const Variable& var = network.variable(variables_[i]);
+    const int num_values = var.num_values();
+    value_indices_[i].resize(num_values, 0);
+    for (int v = 0; v < num_values; ++v) {
+      auto index = indices.insert(std::make_pair(var.value(v),
+                                                 indices.size()));
+      value_indices_[i][v] = index.first->second;
+    }
+  }
+  num_values_ = indices.size();
+  edges_.resize(num_vars);
+  edge_ids_.resize(num_vars);
+  var_match_.resize(num_vars, -1);
+  value_match_.resize(num_values_, -1);
+  residual_.resize(num_vars + num_values_);
+}
+
+bool AllDifferent::Propagate(Network* network, vector<int>* reduced) {
+  const int num_vars = variables_.size();
+  // Build the value graph of the valid values.
+  for (int i = 0; i < num_vars; ++i) {
+    const Variable& var = network->variable(variables_[i]);
+    edge_ids_[i] = var.valid_value_ids();
+    if (edge_ids_[i].empty()) {
+      return false;
+    }
+    edges_[i].clear();
+    for (auto it = edge_ids_[i].cbegin(), end = edge_ids_[i].cend();
+         it != end; ++it) {
+      edges_[i].push_back(value_indices_[i][*it]);
+    }
+  }
+
+  // Repair the matching of the last propagation, then match the remaining
+  // variables.
+  value_match_.assign(num_values_, -1);
+  for (int i = 0; i < num_vars; ++i) {
+    const int value = var_match_[i];
+    if (value != -1 && value_match_[value] == -1 &&
+        find(edges_[i].begin(), edges_[i].end(), value) != edges_[i].end()) {
+      value_match_[value] = i;
+    } else {
+      var_match_[i] = -1;
+    }
+  }
+  for (int i = 0; i < num_vars; ++i) {
+    if (var_match_[i] == -1) {
+      visited_.assign(num_values_, false);
+      if (!Augment(i)) {
+        return false;
+      }
+    }
+  }
+
+  // Build the residual graph and find its strongly connected components.
+  for (int i = 0; i < num_vars; ++i) {
+    residual_[i].assign(1, num_vars + var_match_[i]);
+  }
+  for (int j = 0; j < num_values_; ++j) {
+    residual_[num_vars + j].clear();
+  }
+  for (int i = 0; i < num_vars; ++i) {
+    for (auto it = edges_[i].cbegin(), end = edges_[i].cend();
+         it != end; ++it) {
+      if (*it != var_match_[i]) {
+        residual_[num_vars + *it].push_back(i);
+      }
+    }
+  }
+  const int num_nodes = num_vars + num_values_;
+  index_.assign(num_nodes, -1);
+  low_link_.assign(num_nodes, 0);
+  component_.assign(num_nodes, -1);
+  on_stack_.assign(num_nodes, false);
+  stack_.clear();
+  next_index_ = 0;
+  num_components_ = 0;
+  for (int node = 0; node < num_nodes; ++node) {
+    if (index_[node] == -1) {
+      StrongConnect(node);
+    }
+  }
+
+  // Mark the nodes on alternating paths starting at free values.
+  visited_.assign(num_nodes, false);
+  vector<int> queue;
+  for (int j = 0; j < num_values_; ++j) {
+    if (value_match_[j] == -1) {
+      visited_[num_vars + j] = true;
+      queue.push_back(num_vars + j);
+    }
+  }
+  for (size_t q = 0; q < queue.size(); ++q) {
+    const vector<int>& succs = residual_[queue[q]];
+    for (auto it = succs.cbegin(), end = succs.cend(); it != end; ++it) {
+      if (!visited_[*it]) {
+        visited_[*it] = true;
+        queue.push_back(*it);
+      }
+    }
+  }
+
+  // Remove the unmatched edges which are neither on such a path nor within a
+  // strongly connected component.
+  for (int i = 0; i < num_vars; ++i) {
+    Variable& var = network->variable(variables_[i]);
+    bool removed = false;
+    for (int e = 0, size = edges_[i].size(); e < size; ++e) {
+      const int value = edges_[i][e];
+      if (value != var_match_[i] && !visited_[num_vars + value] &&
+          component_[i] != component_[num_vars + value]) {
+        var.RemoveValue(edge_ids_[i][e]);
+        ++num_prunings_;
+        removed = true;
+      }
+    }
+    if (removed) {
+      reduced->push_back(variables_[i]);
+    }
+  }
+  return true;
+}
+
+bool AllDifferent::Augment(const int var_index) {
+  const vector<int>& values = edges_[var_index];
+  for (auto it = values.cbegin(), end = values.cend(); it != end; ++it) {
+    const int value = *it;
+    if (visited_[value]) {
+      continue;
+    }
+    visited_[value] = true;
+    if (value_match_[value] == -1 || Augment(value_match_[value])) {
+      var_match_[var_index] = value;
+      value_match_[value] = var_index;
+      return true;
+    }
+  }
+  return false;
+}
+
+void AllDifferent::StrongConnect(const int node) {
+  index_[node] = next_index_;
+  low_link_[node] = next_index_;
+  ++next_index_;
+  stack_.push_back(node);
+  on_stack_[node] = true;
+  const vector<int>& succs = residual_[node];
+  for (auto it = succs.cbegin(), end = succs.cend(); it != end; ++it) {
+    const int succ = *it;
+    if (index_[succ] == -1) {
+      StrongConnect(succ);
+      low_link_[node] = min(low_link_[node], low_link_[succ]);
+    } else if (on_stack_[succ]) {
+      low_link_[node] = min(low_link_[node], index_[succ]);
+    }
+  }
+  if (low_link_[node] == index_[node]) {
+    // The node is the root of a component.
+    int member = -1;
+    do {
+      member = stack_.back();
+      stack_.pop_back();
+      on_stack_[member] = false;
+      component_[member] = num_components_;
+    } while (member != node);
+    ++num_components_;
+  }
+}
+
+const vector<int>& AllDifferent::variables() const {
+  return variables_;
+}
+
+int AllDifferent::num_prunings() const {
+  return num_prunings_;
+}
+
+}  // namespace ace
@@ -0,0 +1,66 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#ifndef SRC_ALL_DIFFERENT_H_
+#define SRC_ALL_DIFFERENT_H_
+
+#include <vector>
+
+namespace ace {
+
+class Network;
+
+// Generalised arc-consistency for an all-different constraint (Régin). The
+// valid values of the variables form a bipartite value graph, a value is
+// supported if its edge belongs to some maximum matching covering all
+// variables.
+class AllDifferent {
+ public:
+  // Initialises the constraint on the given variables of the network.
+  AllDifferent(const Network& network, const std::vector<int>& variables);
+
+  // Removes the values without support, adding the variables with reduced
+  // domains to the given list.
+  // Returns false if no matching covers all variables.
+  bool Propagate(Network* network, std::vector<int>* reduced);
+
+  // Returns the variables of the constraint.
+  const std::vector<int>& variables() const;
+
+  // Returns the number of values removed over all propagations.
+  int num_prunings() const;
+
+ private:
+  // Tries to match the variable by an augmenting path.
+  bool Augment(const int var_index);
+
+  // Tarjan's recursive strongly connected components search on the
+  // residual graph, variables are nodes [0, n), values nodes [n, n + m).
+  void StrongConnect(const int node);
+
+  // Returns the successors of the node in the residual graph.
+  const std::vector<int>& successors(const int node) const;
+
+  std::vector<int> variables_;
+  // The value index of each value id by variable.
+  std::vector<std::vector<int> > value_indices_;
+  int num_values_;
+  // The value graph, value indices and ids of the valid values by variable.
+  std::vector<std::vector<int> > edges_;
+  std::vector<std::vector<int> > edge_ids_;
+  std::vector<int> var_match_;
+  std::vector<int> value_match_;
+  std::vector<bool> visited_;
+  // The residual graph: matched edges point from variables to values,
+  // unmatched edges from values to variables.
+  std::vector<std::vector<int> > residual_;
+  std::vector<int> index_;
+  std::vector<int> low_link_;
+  std::vector<int> component_;
+  std::vector<bool> on_stack_;
+  std::vector<int> stack_;
+  int next_index_;
+  int num_components_;
+  int num_prunings_;
+};
+
+}  // namespace ace
+#endif  // SRC_ALL_DIFFERENT_H_
@@ -37,7 +37,9 @@ bool BackjumpSolver::Solve() {
   static const int kInvalidId = -1;
 
   Reset();
-  begin_clock_ = Clock();
+  begin_clock_ = Clock(clock_type_);
+  solutions_.clear();
+  num_solutions_ = 0;
 
   Assignment assignment(network_);
   const int num_variables = network_.num_variables();
@@ -49,12 +51,12 @@ bool BackjumpSolver::Solve() {
     int var_id = var_ordering_[var_seq];
     assert(var_id >= 0 && var_id < num_variables);
     const Variable& var = network_.variable(var_id);
-    domains_[var_id] = var.domain();
+    domains_[var_id] = var.valid_value_ids();
   }
   while (var_seq != kInvalidId && var_seq < num_variables) {
-    if (solutions_.size() >= max_num_solutions_ ||
-        Clock() - begin_clock_ > time_limit_) {
-      // Enough solutions found or time limit reached.
+    if (num_solutions_ >= max_num_solutions_ || cancelled_ ||
+        Clock(clock_type_) - begin_clock_ > time_limit_) {
+      // Enough solutions found, search cancelled or time limit reached.
       break;
     }
     if (SelectValue(var_seq, &assignment)) {
@@ -62,12 +64,12 @@ bool BackjumpSolver::Solve() {
       if (var_seq == num_variables) {
         // Solution found.
         assert(assignment.Complete() && assignment.Consistent());
-        solutions_.push_back(assignment);
+        AddSolution(assignment, &solutions_);
       } else if (var_seq != kInvalidId) {
         const int var_id = var_ordering_[var_seq];
         assert(var_id >= 0 && var_id < num_variables);
         const Variable& var = network_.variable(var_id);
-        domains_[var_id] = var.domain();
+        domains_[var_id] = var.valid_value_ids();
       }
     } else {
       ++num_backtracks_;
@@ -84,8 +86,8 @@ bool BackjumpSolver::Solve() {
     }
   }
 
-  duration_ = Clock() - begin_clock_;
-  return solutions_.size();
+  duration_ = Clock(clock_type_) - begin_clock_;
+  return num_solutions_;
 }
 
 bool BackjumpSolver::SelectValue(const int var_seq, Assignment* assignment) {
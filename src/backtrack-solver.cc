@@ -13,13 +13,25 @@ using std::set;
 using base::Clock;
 using std::numeric_limits;
 using std::min;
+using std::swap;
+using base::RandomGenerator;
 
 namespace ace {
 
+const float BacktrackSolver::kRestartGrowth = 1.5f;
+
+// The seed used for the value shuffling after restarts.
+static const uint32_t kRestartSeed = 0x5a8aff10;
+
 BacktrackSolver::BacktrackSolver(Network* network)
     : Solver(),
       network_(*network),
       preprocessor_(network),
+      nogoods_(network),
+      random_gen_(kRestartSeed),
+      symmetry_breaking_(true),
+      breaking_symmetry_(false),
+      restart_cutoff_(0),
       time_limit_(Solver::kDefTimeLimit),
       max_num_solutions_(Solver::kDefMaxNumSolutions) {
   Reset();
@@ -29,41 +41,92 @@ BacktrackSolver::BacktrackSolver(Network* network)
   for (int i = 0; i < num_vars; ++i) {
     var_ordering_[i] = i;
   }
+  all_different_propagation(true);
 }
 
 bool BacktrackSolver::Solve() {
   Reset();
-  begin_clock_ = Clock();
-  Assignment assignment(network_);
-  SolveRec(&assignment);
-  duration_ = Clock() - begin_clock_;
-  return solutions_.size();
+  begin_clock_ = Clock(clock_type_);
+  solutions_.clear();
+  num_solutions_ = 0;
+  nogoods_.Clear();
+  random_gen_ = RandomGenerator<float>(kRestartSeed);
+  // Restarting would find the solutions of the interrupted branch again.
+  const bool restarts = restart_cutoff_ > 0 && max_num_solutions_ == 1;
+  // Symmetric solutions are only skipped when searching for a single one.
+  breaking_symmetry_ = symmetry_breaking_ && max_num_solutions_ == 1 &&
+                       network_.interchangeable_values();
+  if (breaking_symmetry_) {
+    value_uses_.assign(network_.variable(0).num_values(), 0);
+  }
+  double cutoff = restart_cutoff_;
+  network_.StartTransaction();
+  if (!PropagateAllDifferent()) {
+    // The root network has no solutions.
+    network_.RollbackTransaction();
+    duration_ = Clock(clock_type_) - begin_clock_;
+    return false;
+  }
+  do {
+    restarting_ = false;
+    restart_limit_ = restarts ?
+      min<double>(num_backtracks_ + cutoff, numeric_limits<int>::max()) :
+      numeric_limits<int>::max();
+    Assignment assignment(network_);
+    SolveRec(&assignment);
+    if (restarting_) {
+      ++num_restarts_;
+      cutoff *= kRestartGrowth;
+    }
+  } while (restarting_);
+  network_.RollbackTransaction();
+  duration_ = Clock(clock_type_) - begin_clock_;
+  return num_solutions_;
 }
 
 bool BacktrackSolver::SolveRec(Assignment* assignment) {
   if (assignment->Complete()) {
     // Solution found.
     assert(assignment->Consistent());
-    solutions_.push_back(*assignment);
-    return solutions_.size() >= max_num_solutions_;
-  } else if (Clock() - begin_clock_ > time_limit_) {
-    // Time limit reached.
+    AddSolution(*assignment, &solutions_);
+    return num_solutions_ >= max_num_solutions_;
+  } else if (cancelled_ || Clock(clock_type_) - begin_clock_ > time_limit_) {
+    // Time limit reached or search cancelled.
+    timeout_ = true;
     return false;
   }
   // Select the next variable according to the ordering.
   const int var_id = var_ordering_[assignment->num_assigned()];
   Variable& var = network_.variable(var_id);
-  const vector<int> domain = var.valid_value_ids();
+  vector<int> domain = var.valid_value_ids();
+  if (num_restarts_) {
+    ShuffleValues(&domain);
+  }
+  // The values refuted on this level of the current branch.
+  vector<int> refuted;
+  // Whether a value unused by the current assignment has been tried.
+  bool unused_tried = false;
   for (auto it = domain.rbegin(), end = domain.rend(); it != end; ++it) {
     const int value = *it;
+    if (breaking_symmetry_ && !value_uses_[value]) {
+      if (unused_tried) {
+        // The unused values are interchangeable.
+        ++num_symmetry_prunings_;
+        continue;
+      }
+      unused_tried = true;
+    }
     ++num_explored_states_;
     assignment->Assign(var_id, value);
+    if (breaking_symmetry_) {
+      ++value_uses_[value];
+    }
     if (assignment->Consistent()) {
       // Start a transaction to track all domain changes.
       network_.StartTransaction();
       // Reduce the domain of the selected variable for the consistency test.
       var.ReduceDomain(value);
-      if (preprocessor_.Propagate(var_id) &&
+      if (Propagate(var_id, value, *assignment) &&
           SolveRec(assignment)) {
         // Commit the transaction, stops tracking changes.
         network_.CommitTransaction();
@@ -71,17 +134,114 @@ bool BacktrackSolver::SolveRec(Assignment* assignment) {
       }
       // Rollback all tracked domain changes.
       network_.RollbackTransaction();
-      ++num_backtracks_;
+      if (!restarting_) {
+        // The subtree has been fully explored.
+        refuted.push_back(value);
+        ++num_backtracks_;
+        restarting_ = !timeout_ && num_backtracks_ >= restart_limit_;
+      }
+    } else {
+      refuted.push_back(value);
     }
     // Revert the last assignment.
     assignment->Revert();
+    if (breaking_symmetry_) {
+      --value_uses_[value];
+    }
+    if (restarting_) {
+      // Unwind the search and keep the refuted decisions of this branch.
+      if (!RecordNogoods(*assignment, var_id, refuted)) {
+        // The root network became inconsistent, no need to restart.
+        restarting_ = false;
+      }
+      return false;
+    }
   }
   return false;
 }
 
+bool BacktrackSolver::Propagate(const int var_id, const int value,
+                                const Assignment& assignment) {
+  if (!preprocessor_.Propagate(var_id)) {
+    return false;
+  }
+  if (nogoods_.num_nogoods()) {
+    vector<int> reduced;
+    if (!nogoods_.Propagate(var_id, value, assignment, &reduced)) {
+      return false;
+    }
+    for (auto it = reduced.cbegin(), end = reduced.cend(); it != end; ++it) {
+      if (!preprocessor_.Propagate(*it)) {
+        return false;
+      }
+    }
+  }
+  return PropagateAllDifferent();
+}
+
+bool BacktrackSolver::PropagateAllDifferent() {
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (auto it = all_different_.begin(), end = all_different_.end();
+         it != end; ++it) {
+      vector<int> reduced;
+      if (!it->Propagate(&network_, &reduced)) {
+        return false;
+      }
+      for (auto it2 = reduced.cbegin(), end2 = reduced.cend();
+           it2 != end2; ++it2) {
+        if (!preprocessor_.Propagate(*it2)) {
+          return false;
+        }
+      }
+      changed = changed || reduced.size();
+    }
+  }
+  return true;
+}
+
+bool BacktrackSolver::RecordNogoods(const Assignment& assignment,
+                                    const int var_id,
+                                    const vector<int>& refuted) {
+  if (timeout_ || refuted.empty()) {
+    // Values refuted by a timeout are not proven to be inconsistent.
+    return true;
+  }
+  // The positive decisions above the current level.
+  const int depth = assignment.num_assigned();
+  vector<NogoodBase::Literal> literals;
+  literals.reserve(depth + 1);
+  for (int i = 0; i < depth; ++i) {
+    const int decision_var_id = var_ordering_[i];
+    literals.push_back(NogoodBase::Literal(decision_var_id,
+                                           assignment.value(decision_var_id)));
+  }
+  // Each negative decision var_id != value yields a reduced nld-nogood.
+  literals.push_back(NogoodBase::Literal(var_id, 0));
+  for (auto it = refuted.cbegin(), end = refuted.cend(); it != end; ++it) {
+    literals.back().value = *it;
+    nogoods_.Add(literals);
+  }
+  if (depth == 0) {
+    // Unary nogoods have reduced the root domain.
+    return preprocessor_.Propagate(var_id);
+  }
+  return true;
+}
+
+void BacktrackSolver::ShuffleValues(vector<int>* values) {
+  for (int i = values->size() - 1; i > 0; --i) {
+    const int j = random_gen_.Next() * (i + 1);
+    swap((*values)[i], (*values)[j]);
+  }
+}
+
 bool BacktrackSolver::SolveIterative() {
   Reset();
-  const Clock beg;
+  solutions_.clear();
+  num_solutions_ = 0;
+  const Clock beg(clock_type_);
   // Initialise the assignments stack with the empty assignment.
   vector<Assignment> stack(1, Assignment(network_));
   while (stack.size()) {
@@ -90,11 +250,11 @@ bool BacktrackSolver::SolveIterative() {
     if (assignment.Complete()) {
       // Solution found.
       assert(assignment.Consistent());
-      solutions_.push_back(assignment);
-      if (solutions_.size() >= max_num_solutions_) {
+      AddSolution(assignment, &solutions_);
+      if (num_solutions_ >= max_num_solutions_) {
         break;
       }
-    } else if (Clock() - begin_clock_ > time_limit_) {
+    } else if (Clock(clock_type_) - begin_clock_ > time_limit_) {
       break;
     }
     const int var_id = assignment.SelectUnassigned();
@@ -111,20 +271,51 @@ bool BacktrackSolver::SolveIterative() {
       assignment.Revert();
     }
   }
-  duration_ = Clock() - beg;
-  return solutions_.size();
+  duration_ = Clock(clock_type_) - beg;
+  return num_solutions_;
 }
 
 void BacktrackSolver::Reset() {
   duration_ = 0;
   num_backtracks_ = 0;
   num_explored_states_ = 0.0;
+  num_restarts_ = 0;
+  num_symmetry_prunings_ = 0;
+  restarting_ = false;
+  timeout_ = false;
+  nogoods_.Reset();
 }
 
 void BacktrackSolver::variable_ordering(const VariableOrdering& var_ordering) {
   var_ordering_ = var_ordering.CreateOrdering();
 }
 
+void BacktrackSolver::restart_cutoff(const int cutoff) {
+  restart_cutoff_ = cutoff > 0 ? cutoff : 0;
+}
+
+int BacktrackSolver::restart_cutoff() const {
+  return restart_cutoff_;
+}
+
+void BacktrackSolver::all_different_propagation(const bool enabled) {
+  all_different_.clear();
+  if (enabled) {
+    const vector<vector<int> >& scopes = network_.all_different();
+    for (auto it = scopes.cbegin(), end = scopes.cend(); it != end; ++it) {
+      all_different_.push_back(AllDifferent(network_, *it));
+    }
+  }
+}
+
+void BacktrackSolver::value_symmetry_breaking(const bool enabled) {
+  symmetry_breaking_ = enabled;
+}
+
+void BacktrackSolver::max_num_nogood_literals(const int num) {
+  nogoods_.max_num_literals(num);
+}
+
 void BacktrackSolver::time_limit(const Clock::Diff& limit) {
   time_limit_ = min(limit, Solver::kDefTimeLimit);
 }
@@ -153,6 +344,31 @@ int BacktrackSolver::num_backtracks() const {
   return num_backtracks_;
 }
 
+int BacktrackSolver::num_restarts() const {
+  return num_restarts_;
+}
+
+int BacktrackSolver::num_nogoods() const {
+  return nogoods_.num_nogoods();
+}
+
+int BacktrackSolver::num_nogood_prunings() const {
+  return nogoods_.num_prunings();
+}
+
+int BacktrackSolver::num_symmetry_prunings() const {
+  return num_symmetry_prunings_;
+}
+
+int BacktrackSolver::num_all_different_prunings() const {
+  int num_prunings = 0;
+  for (auto it = all_different_.cbegin(), end = all_different_.cend();
+       it != end; ++it) {
+    num_prunings += it->num_prunings();
+  }
+  return num_prunings;
+}
+
 Clock::Diff BacktrackSolver::duration() const {
   return duration_;
 }
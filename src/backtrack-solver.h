@@ -7,6 +7,9 @@
 #include "./clock.h"
 #include "./assignment.h"
 #include "./ac3.h"
+#include "./nogood-base.h"
+#include "./all-different.h"
+#include "./random.h"
 
 namespace ace {
 
@@ -22,6 +25,7 @@ class BacktrackSolver : public Solver {
  public:
   static const base::Clock::Diff kDefTimeLimit;
   static const int kDefMaxNumSolutions;
+  static const float kRestartGrowth;
 
   // Initialises the solver with the given network.
   explicit BacktrackSolver(Network* network);
@@ -40,6 +44,26 @@ class BacktrackSolver : public Solver {
   // Sets the variable ordering.
   void variable_ordering(const VariableOrdering& var_ordering);
 
+  // Sets the number of backtracks before the first restart (0 disables
+  // restarts). The cutoff grows geometrically with each restart. Restarts are
+  // only used when searching for a single solution.
+  void restart_cutoff(const int cutoff);
+
+  // Returns the number of backtracks before the first restart.
+  int restart_cutoff() const;
+
+  // Sets whether the all-different constraints of the network are propagated
+  // by matching alongside arc-consistency.
+  void all_different_propagation(const bool enabled);
+
+  // Sets whether the symmetry of interchangeable values is broken during
+  // search, by trying only one value not used by the current assignment.
+  // Symmetry breaking is only used when searching for a single solution.
+  void value_symmetry_breaking(const bool enabled);
+
+  // Sets the maximum number of literals stored in the nogood base.
+  void max_num_nogood_literals(const int num);
+
   // Sets the time limit for the search. Search will be terminated if the time
   // limit is exceeded, returning false.
   void time_limit(const base::Clock::Diff& limit);
@@ -65,16 +89,69 @@ class BacktrackSolver : public Solver {
   // Returns the number of states explored during the last search.
   double num_explored_states() const;
 
+  // Returns the number of restarts during the last search.
+  int num_restarts() const;
+
+  // Returns the number of nogoods recorded during the last search.
+  int num_nogoods() const;
+
+  // Returns the number of domain values pruned by nogoods during the last
+  // search.
+  int num_nogood_prunings() const;
+
+  // Returns the number of values skipped as symmetric to an unused value
+  // during the last search.
+  int num_symmetry_prunings() const;
+
+  // Returns the number of domain values pruned by the all-different
+  // constraints.
+  int num_all_different_prunings() const;
+
  private:
   // The recursive search function.
   bool SolveRec(Assignment* assignment);
 
+  // Propagates the decision var_id = value with arc-consistency and the
+  // nogood base.
+  // Returns whether the network is still consistent.
+  bool Propagate(const int var_id, const int value,
+                 const Assignment& assignment);
+
+  // Propagates the all-different constraints and arc-consistency to a
+  // fixpoint.
+  // Returns whether the network is still consistent.
+  bool PropagateAllDifferent();
+
+  // Records the reduced nld-nogoods for the refuted values of the given
+  // variable, extracted from the positive decisions of the current branch.
+  // Returns false if the recorded unary nogoods make the network
+  // inconsistent.
+  bool RecordNogoods(const Assignment& assignment, const int var_id,
+                     const std::vector<int>& refuted);
+
+  // Shuffles the value order, used to diversify the search after restarts.
+  void ShuffleValues(std::vector<int>* values);
+
   Network& network_;
   Ac3 preprocessor_;
+  NogoodBase nogoods_;
+  std::vector<AllDifferent> all_different_;
+  base::RandomGenerator<float> random_gen_;
   std::vector<int> var_ordering_;
   std::vector<Assignment> solutions_;
+  // The number of assigned variables by value id, tracked for value symmetry
+  // breaking.
+  std::vector<int> value_uses_;
+  bool symmetry_breaking_;
+  bool breaking_symmetry_;
   double num_explored_states_;
   int num_backtracks_;
+  int num_restarts_;
+  int num_symmetry_prunings_;
+  int restart_cutoff_;
+  int restart_limit_;
+  bool restarting_;
+  bool timeout_;
   base::Clock begin_clock_;
   base::Clock::Diff duration_;
   base::Clock::Diff time_limit_;
@@ -0,0 +1,74 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include "./best-ordering.h"
+#include <functional>
+#include <limits>
+#include <thread>
+#include <vector>
+#include "./network.h"
+#include "./min-width-ordering.h"
+#include "./max-cardinality-ordering.h"
+#include "./min-fill-ordering.h"
+
+using std::vector;
+using std::thread;
+using std::cref;
+
+namespace ace {
+
+// The maximum number of fill edges added by the min-fill candidate, which is
+// skipped beyond that.
+static const int64_t kMaxNumFillEdges = 1 << 18;
+
+// The evaluation of a candidate ordering, executed on a separate thread.
+static void EvaluateOrdering(const Network& network, const int candidate,
+                             vector<int>* ordering, int* width) {
+  switch (candidate) {
+    case 0: {
+      const int num_variables = network.num_variables();
+      ordering->resize(num_variables, 0);
+      for (int i = 0; i < num_variables; ++i) {
+        (*ordering)[i] = i;
+      }
+      break;
+    }
+    case 1:
+      *ordering = MinWidthOrdering(network).CreateOrdering();
+      break;
+    case 2:
+      *ordering = MaxCardinalityOrdering(network).CreateOrdering();
+      break;
+    default:
+      *ordering = MinFillOrdering(network, kMaxNumFillEdges).CreateOrdering();
+      if (ordering->empty() && network.num_variables()) {
+        // Skipped.
+        *width = std::numeric_limits<int>::max();
+        return;
+      }
+  }
+  *width = VariableOrdering::InducedWidth(network, *ordering);
+}
+
+BestOrdering::BestOrdering(const Network& network)
+    : network_(network) {}
+
+vector<int> BestOrdering::CreateOrdering() const {
+  const int num_candidates = 4;
+  vector<vector<int> > orderings(num_candidates);
+  vector<int> widths(num_candidates, 0);
+  vector<thread> threads;
+  threads.reserve(num_candidates);
+  for (int c = 0; c < num_candidates; ++c) {
+    threads.push_back(thread(EvaluateOrdering, cref(network_), c,
+                             &orderings[c], &widths[c]));
+  }
+  int best = 0;
+  for (int c = 0; c < num_candidates; ++c) {
+    threads[c].join();
+    if (widths[c] < widths[best]) {
+      best = c;
+    }
+  }
+  return orderings[best];
+}
+
+}  // namespace ace
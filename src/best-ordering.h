@@ -0,0 +1,25 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#ifndef SRC_BEST_ORDERING_H_
+#define SRC_BEST_ORDERING_H_
+
+#include <vector>
+#include "./variable-ordering.h"
+
+namespace ace {
+
+class Network;
+
+// Evaluates the lexicographic, min-width, max-cardinality and min-fill
+// orderings concurrently and selects the one with the smallest induced width,
+// ties are broken in that order. The min-fill ordering is skipped when its
+// elimination adds too many fill edges.
+class BestOrdering : public VariableOrdering {
+ public:
+  explicit BestOrdering(const Network& network);
+  std::vector<int> CreateOrdering() const;
+ private:
+  const Network& network_;
+};
+
+}  // namespace ace
+#endif  // SRC_BEST_ORDERING_H_
@@ -0,0 +1,219 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include "./breakout-solver.h"
+#include <cassert>
+#include <vector>
+#include <algorithm>
+#include "./clock.h"
+#include "./network.h"
+#include "./conflict-table.h"
+#include "./random.h"
+
+using std::vector;
+using std::min;
+using std::max;
+using std::fill;
+using base::Clock;
+using base::RandomGenerator;
+
+namespace ace {
+
+const int BreakoutSolver::kDefMaxWeight = 1 << 12;
+const uint32_t BreakoutSolver::kDefSeed = 0x5a8aff10;
+
+// The number of steps between time limit checks.
+static const int kCheckInterval = 256;
+
+BreakoutSolver::BreakoutSolver(Network* network)
+    : Solver(),
+      network_(*network),
+      var_marks_(network->num_variables(), 0),
+      max_weight_(kDefMaxWeight),
+      time_limit_(Solver::kDefTimeLimit),
+      max_num_solutions_(Solver::kDefMaxNumSolutions),
+      random_gen_(kDefSeed) {
+  Reset();
+}
+
+bool BreakoutSolver::Solve() {
+  Reset();
+  begin_clock_ = Clock(clock_type_);
+  solutions_.clear();
+  num_solutions_ = 0;
+  ConflictTable table(network_);
+  const int num_vars = network_.num_variables();
+  for (int v = 0; v < num_vars; ++v) {
+    if (table.domain(v).empty()) {
+      // Networks with empty domains have no solutions.
+      duration_ = Clock(clock_type_) - begin_clock_;
+      return false;
+    }
+  }
+
+  Assignment assignment(network_);
+  RandomAssignment(table, &assignment);
+  table.Init(assignment);
+  for (int iteration = 0; ; ++iteration) {
+    if (iteration % kCheckInterval == 0 &&
+        (cancelled_ || Clock(clock_type_) - begin_clock_ > time_limit_)) {
+      // Search cancelled or time limit reached.
+      break;
+    }
+    const int num_violated = table.num_violated_constraints();
+    best_num_violated_ = min(best_num_violated_, num_violated);
+    if (!num_violated) {
+      // Solution found.
+      assert(assignment.Consistent());
+      AddSolution(assignment, &solutions_);
+      if (num_solutions_ >= max_num_solutions_) {
+        break;
+      }
+      // Continue from a random assignment for further solutions.
+      RandomAssignment(table, &assignment);
+      table.Init(assignment);
+      continue;
+    }
+    int variable = 0;
+    int value = 0;
+    if (SelectMove(table, &variable, &value)) {
+      ++num_steps_;
+      table.Flip(variable, value);
+      assignment.Reassign(variable, value);
+    } else {
+      // Local minimum, increase the weights of the violated constraints.
+      ++num_breakouts_;
+      const vector<int> violated = table.violated_constraints();
+      for (auto it = violated.cbegin(), end = violated.cend();
+           it != end; ++it) {
+        table.IncreaseWeight(*it);
+      }
+      if (table.max_weight() >= max_weight_) {
+        // Bound the weight growth.
+        table.DecayWeights();
+      }
+    }
+  }
+
+  duration_ = Clock(clock_type_) - begin_clock_;
+  return num_solutions_;
+}
+
+bool BreakoutSolver::complete() const {
+  return false;
+}
+
+bool BreakoutSolver::SelectMove(const ConflictTable& table, int* variable,
+                                int* value) {
+  int best_score = table.violated_weight();
+  int num_ties = 0;
+  ++mark_;
+  const vector<int>& violated = table.violated_constraints();
+  for (auto it = violated.cbegin(), end = violated.cend(); it != end; ++it) {
+    const Constraint& constraint = network_.constraint(*it);
+    const int arity = constraint.arity();
+    for (int i = 0; i < arity; ++i) {
+      const int var_id = constraint.scope(i);
+      if (var_marks_[var_id] == mark_) {
+        continue;
+      }
+      var_marks_[var_id] = mark_;
+      const vector<int>& domain = table.domain(var_id);
+      for (auto it2 = domain.cbegin(), end2 = domain.cend();
+           it2 != end2; ++it2) {
+        const int score = table.Score(var_id, *it2);
+        if (score < best_score) {
+          best_score = score;
+          num_ties = 1;
+          *variable = var_id;
+          *value = *it2;
+        } else if (num_ties && score == best_score &&
+                   random_gen_.Next() * ++num_ties < 1.0f) {
+          // Uniform selection among equally good moves.
+          *variable = var_id;
+          *value = *it2;
+        }
+      }
+    }
+  }
+  return num_ties;
+}
+
+void BreakoutSolver::RandomAssignment(const ConflictTable& table,
+                                      Assignment* assignment) {
+  const int num_vars = network_.num_variables();
+  for (int v = 0; v < num_vars; ++v) {
+    const vector<int>& domain = table.domain(v);
+    const int value = domain[random_gen_.Next() * domain.size()];
+    if (assignment->Assigned(v)) {
+      assignment->Reassign(v, value);
+    } else {
+      assignment->Assign(v, value);
+    }
+  }
+}
+
+void BreakoutSolver::Reset() {
+  duration_ = 0;
+  best_num_violated_ = network_.num_constraints();
+  num_steps_ = 0;
+  num_breakouts_ = 0;
+  mark_ = 0;
+  fill(var_marks_.begin(), var_marks_.end(), 0);
+}
+
+void BreakoutSolver::max_weight(const int weight) {
+  max_weight_ = max(2, weight);
+}
+
+int BreakoutSolver::max_weight() const {
+  return max_weight_;
+}
+
+void BreakoutSolver::seed(const uint32_t seed) {
+  random_gen_ = RandomGenerator<float>(seed);
+}
+
+void BreakoutSolver::time_limit(const Clock::Diff& limit) {
+  time_limit_ = min(limit, Solver::kDefTimeLimit);
+}
+
+Clock::Diff BreakoutSolver::time_limit() const {
+  return time_limit_;
+}
+
+void BreakoutSolver::max_num_solutions(const int num) {
+  max_num_solutions_ = num > 0 ? num : Solver::kDefMaxNumSolutions;
+}
+
+int BreakoutSolver::max_num_solutions() const {
+  return max_num_solutions_;
+}
+
+const vector<Assignment>& BreakoutSolver::solutions() const {
+  return solutions_;
+}
+
+int BreakoutSolver::best_num_violated() const {
+  return best_num_violated_;
+}
+
+int BreakoutSolver::num_steps() const {
+  return num_steps_;
+}
+
+int BreakoutSolver::num_breakouts() const {
+  return num_breakouts_;
+}
+
+int BreakoutSolver::num_backtracks() const {
+  return 0;
+}
+
+double BreakoutSolver::num_explored_states() const {
+  return num_steps_;
+}
+
+Clock::Diff BreakoutSolver::duration() const {
+  return duration_;
+}
+
+}  // namespace ace
@@ -0,0 +1,110 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#ifndef SRC_BREAKOUT_SOLVER_H_
+#define SRC_BREAKOUT_SOLVER_H_
+
+#include <vector>
+#include "./solver.h"
+#include "./clock.h"
+#include "./random.h"
+#include "./assignment.h"
+
+namespace ace {
+
+// The constraint network.
+class Network;
+class ConflictTable;
+
+// A constraint network solver based on Morris' breakout method. It greedily
+// minimises the weighted number of violated constraints. In local minima, the
+// weights of the violated constraints are increased, which changes the
+// landscape until an improving move exists. Weights are halved when the
+// maximum weight is reached. The search is incomplete.
+class BreakoutSolver : public Solver {
+ public:
+  static const int kDefMaxWeight;
+  static const uint32_t kDefSeed;
+
+  // Initialises the solver with the given network.
+  explicit BreakoutSolver(Network* network);
+
+  // Searches for a solution for the network.
+  // Returns whether it found a solution.
+  bool Solve();
+
+  // Returns false, the search can only prove satisfiability.
+  bool complete() const;
+
+  // Resets the solver meta-information, which is collected during search.
+  void Reset();
+
+  // Sets the weight at which all constraint weights are halved.
+  void max_weight(const int weight);
+
+  // Returns the set maximum weight.
+  int max_weight() const;
+
+  // Sets the seed of the random generator.
+  void seed(const uint32_t seed);
+
+  // Sets the time limit for the search. Search will be terminated if the time
+  // limit is exceeded, returning false.
+  void time_limit(const base::Clock::Diff& limit);
+
+  // Returns the set time limit.
+  base::Clock::Diff time_limit() const;
+
+  // Sets the maximum number of solutions to be searched for.
+  void max_num_solutions(const int num);
+
+  // Returns the set maximum number of solutions to be searched for.
+  int max_num_solutions() const;
+
+  // Returns a const reference to the solutions found by the last search.
+  const std::vector<Assignment>& solutions() const;
+
+  // Returns the duration of the last search in microseconds.
+  base::Clock::Diff duration() const;
+
+  // Returns the number of violated constraints of the best assignment found
+  // during the last search.
+  int best_num_violated() const;
+
+  // Returns the number of value changes during the last search.
+  int num_steps() const;
+
+  // Returns the number of weight increases (breakouts) during the last search.
+  int num_breakouts() const;
+
+  // Returns the number of backtracks used during the last search.
+  int num_backtracks() const;
+
+  // Returns the number of states explored during the last search.
+  double num_explored_states() const;
+
+ private:
+  // Assigns random values to all variables.
+  void RandomAssignment(const ConflictTable& table, Assignment* assignment);
+
+  // Selects the move with the best weighted score among the variables of the
+  // violated constraints.
+  // Returns false if no move improves the weighted score.
+  bool SelectMove(const ConflictTable& table, int* variable, int* value);
+
+  Network& network_;
+  std::vector<Assignment> solutions_;
+  // Marks the variables already evaluated during the move selection.
+  std::vector<int> var_marks_;
+  int mark_;
+  int best_num_violated_;
+  int num_steps_;
+  int num_breakouts_;
+  int max_weight_;
+  base::Clock begin_clock_;
+  base::Clock::Diff duration_;
+  base::Clock::Diff time_limit_;
+  size_t max_num_solutions_;
+  base::RandomGenerator<float> random_gen_;
+};
+
+}  // namespace ace
+#endif  // SRC_BREAKOUT_SOLVER_H_
@@ -0,0 +1,328 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include "./btd-solver.h"
+#include <cassert>
+#include <cstdint>
+#include <set>
+#include <vector>
+#include <algorithm>
+#include "./clock.h"
+#include "./network.h"
+#include "./variable-ordering.h"
+
+using std::vector;
+using std::set;
+using std::min;
+using std::max;
+using base::Clock;
+
+namespace ace {
+
+size_t BtdSolver::KeyHash::operator()(const Key& key) const {
+  // FNV-1a combination of the values, with their high bits folded in.
+  uint64_t h = 0xcbf29ce484222325ull;
+  for (auto it = key.cbegin(), end = key.cend(); it != end; ++it) {
+    h = (h ^ static_cast<uint32_t>(*it)) * 0x100000001b3ull;
+    h ^= h >> 29;
+  }
+  return h;
+}
+
+BtdSolver::BtdSolver(Network* network)
+    : Solver(),
+      network_(*network),
+      time_limit_(Solver::kDefTimeLimit),
+      max_num_solutions_(1) {
+  Reset();
+  // Set the lexicographical variable ordering.
+  const int num_vars = network_.num_variables();
+  var_ordering_.resize(num_vars, 0);
+  for (int i = 0; i < num_vars; ++i) {
+    var_ordering_[i] = i;
+  }
+  Decompose();
+}
+
+void BtdSolver::Decompose() {
+  const int num_vars = network_.num_variables();
+  vector<int> positions(num_vars, 0);
+  for (int i = 0; i < num_vars; ++i) {
+    positions[var_ordering_[i]] = i;
+  }
+  // Eliminate the variables in reversed order to find their parents (earlier
+  // neighbours) in the induced graph.
+  vector<set<int> > graph = VariableOrdering::PrimalGraph(network_);
+  vector<vector<int> > parents(num_vars);
+  for (int i = num_vars - 1; i >= 0; --i) {
+    const int var_id = var_ordering_[i];
+    const set<int>& neighs = graph[var_id];
+    vector<int>& var_parents = parents[var_id];
+    for (auto it = neighs.cbegin(), end = neighs.cend(); it != end; ++it) {
+      if (positions[*it] < i) {
+        var_parents.push_back(*it);
+      }
+    }
+    for (auto it = var_parents.cbegin(), end = var_parents.cend();
+         it != end; ++it) {
+      for (auto it2 = var_parents.cbegin(); it2 != end; ++it2) {
+        if (*it != *it2) {
+          graph[*it].insert(*it2);
+        }
+      }
+    }
+  }
+
+  // Each variable joins the cluster of its latest parent if its parents
+  // are all the variables of that cluster, otherwise it opens a new child
+  // cluster separated by its parents.
+  clusters_.assign(1, Cluster());
+  vector<int> var_clusters(num_vars, 0);
+  for (int i = 0; i < num_vars; ++i) {
+    const int var_id = var_ordering_[i];
+    const vector<int>& var_parents = parents[var_id];
+    int latest = -1;
+    for (auto it = var_parents.cbegin(), end = var_parents.cend();
+         it != end; ++it) {
+      if (latest == -1 || positions[*it] > positions[latest]) {
+        latest = *it;
+      }
+    }
+    const int parent_id = latest == -1 ? 0 : var_clusters[latest];
+    Cluster& parent = clusters_[parent_id];
+    if (parent_id && var_parents.size() ==
+        parent.separator.size() + parent.variables.size()) {
+      // The parent cluster is contained by the cluster of the variable.
+      parent.variables.push_back(var_id);
+      var_clusters[var_id] = parent_id;
+    } else {
+      const int cluster_id = clusters_.size();
+      parent.children.push_back(cluster_id);
+      clusters_.push_back(Cluster());
+      Cluster& cluster = clusters_.back();
+      cluster.separator = var_parents;
+      cluster.variables.push_back(var_id);
+      var_clusters[var_id] = cluster_id;
+    }
+  }
+  // Children are created after their parents.
+  for (int c = clusters_.size() - 1; c >= 0; --c) {
+    Cluster& cluster = clusters_[c];
+    cluster.subtree.insert(cluster.subtree.end(), cluster.variables.begin(),
+                           cluster.variables.end());
+    for (auto it = cluster.children.cbegin(), end = cluster.children.cend();
+         it != end; ++it) {
+      const vector<int>& subtree = clusters_[*it].subtree;
+      cluster.subtree.insert(cluster.subtree.end(), subtree.begin(),
+                             subtree.end());
+    }
+  }
+  assert(static_cast<int>(clusters_.front().subtree.size()) == num_vars);
+}
+
+bool BtdSolver::Solve() {
+  Reset();
+  begin_clock_ = Clock(clock_type_);
+  solutions_.clear();
+  num_solutions_ = 0;
+  for (auto it = clusters_.begin(), end = clusters_.end(); it != end; ++it) {
+    it->goods.clear();
+    it->nogoods.clear();
+  }
+  const int num_vars = network_.num_variables();
+  values_.assign(num_vars, Assignment::kUnassigned);
+  Assignment assignment(network_);
+  if (SolveChildren(0, &assignment)) {
+    // Complete the assignment with the values of the subtrees covered by
+    // goods.
+    Assignment solution(network_);
+    for (int i = 0; i < num_vars; ++i) {
+      solution.Assign(i, values_[i]);
+    }
+    assert(solution.Consistent());
+    AddSolution(solution, &solutions_);
+  }
+  duration_ = Clock(clock_type_) - begin_clock_;
+  return num_solutions_;
+}
+
+bool BtdSolver::SolveCluster(const int cluster_id, const int index,
+                             Assignment* assignment) {
+  const Cluster& cluster = clusters_[cluster_id];
+  if (index == static_cast<int>(cluster.variables.size())) {
+    return SolveChildren(cluster_id, assignment);
+  } else if (cancelled_ || Clock(clock_type_) - begin_clock_ > time_limit_) {
+    // Time limit reached or search cancelled.
+    timeout_ = true;
+    return false;
+  }
+  const int var_id = cluster.variables[index];
+  const vector<int> domain = network_.variable(var_id).valid_value_ids();
+  for (auto it = domain.rbegin(), end = domain.rend(); it != end; ++it) {
+    const int value = *it;
+    ++num_explored_states_;
+    assignment->Assign(var_id, value);
+    if (Consistent(var_id, *assignment)) {
+      values_[var_id] = value;
+      if (SolveCluster(cluster_id, index + 1, assignment)) {
+        return true;
+      }
+      ++num_backtracks_;
+    }
+    // Revert the last assignment.
+    assignment->Revert();
+    if (timeout_) {
+      break;
+    }
+  }
+  return false;
+}
+
+bool BtdSolver::SolveChildren(const int cluster_id, Assignment* assignment) {
+  const int num_assigned = assignment->num_assigned();
+  const vector<int>& children = clusters_[cluster_id].children;
+  bool consistent = true;
+  for (auto it = children.cbegin(), end = children.cend();
+       it != end && consistent; ++it) {
+    Cluster& child = clusters_[*it];
+    Key key;
+    key.reserve(child.separator.size());
+    for (auto it2 = child.separator.cbegin(), end2 = child.separator.cend();
+         it2 != end2; ++it2) {
+      key.push_back(assignment->value(*it2));
+    }
+    auto good = child.goods.find(key);
+    if (good != child.goods.end()) {
+      // The subtree is known to be consistent with the separator values.
+      ++num_good_hits_;
+      const vector<int>& values = good->second;
+      for (int i = 0, size = values.size(); i < size; ++i) {
+        values_[child.subtree[i]] = values[i];
+      }
+    } else if (child.nogoods.count(key)) {
+      // The subtree is known to be inconsistent with the separator values.
+      ++num_good_hits_;
+      consistent = false;
+    } else if (SolveCluster(*it, 0, assignment)) {
+      vector<int>& values = child.goods[key];
+      values.reserve(child.subtree.size());
+      for (auto it2 = child.subtree.cbegin(), end2 = child.subtree.cend();
+           it2 != end2; ++it2) {
+        values.push_back(values_[*it2]);
+      }
+    } else {
+      if (!timeout_) {
+        // Values refuted by a timeout are not proven to be inconsistent.
+        child.nogoods.insert(key);
+      }
+      consistent = false;
+    }
+  }
+  if (!consistent) {
+    // Revert the assignments of the solved child subtrees.
+    while (assignment->num_assigned() > num_assigned) {
+      assignment->Revert();
+    }
+  }
+  return consistent;
+}
+
+bool BtdSolver::Consistent(const int var_id,
+                           const Assignment& assignment) const {
+  const vector<int>& cons = network_.constraints(var_id);
+  vector<int> values;
+  for (auto it = cons.cbegin(), end = cons.cend(); it != end; ++it) {
+    const Constraint& constraint = network_.constraint(*it);
+    const vector<int>& scope = constraint.scope();
+    values.clear();
+    for (auto it2 = scope.cbegin(), end2 = scope.cend(); it2 != end2; ++it2) {
+      if (!assignment.Assigned(*it2)) {
+        break;
+      }
+      values.push_back(assignment.value(*it2));
+    }
+    if (values.size() == scope.size() && !constraint.Supports(values)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void BtdSolver::Reset() {
+  duration_ = 0;
+  num_backtracks_ = 0;
+  num_explored_states_ = 0.0;
+  num_good_hits_ = 0;
+  timeout_ = false;
+}
+
+void BtdSolver::variable_ordering(const VariableOrdering& var_ordering) {
+  var_ordering_ = var_ordering.CreateOrdering();
+  Decompose();
+}
+
+void BtdSolver::time_limit(const Clock::Diff& limit) {
+  time_limit_ = min(limit, Solver::kDefTimeLimit);
+}
+
+Clock::Diff BtdSolver::time_limit() const {
+  return time_limit_;
+}
+
+void BtdSolver::max_num_solutions(const int num) {
+  // Goods only keep a single extension of the separator values.
+  max_num_solutions_ = 1;
+}
+
+int BtdSolver::max_num_solutions() const {
+  return max_num_solutions_;
+}
+
+const vector<Assignment>& BtdSolver::solutions() const {
+  return solutions_;
+}
+
+double BtdSolver::num_explored_states() const {
+  return num_explored_states_;
+}
+
+int BtdSolver::num_backtracks() const {
+  return num_backtracks_;
+}
+
+int BtdSolver::num_clusters() const {
+  // Excluding the empty root cluster.
+  return clusters_.size() - 1;
+}
+
+int BtdSolver::width() const {
+  size_t max_size = 0;
+  for (auto it = clusters_.cbegin(), end = clusters_.cend(); it != end; ++it) {
+    max_size = max(max_size, it->separator.size() + it->variables.size());
+  }
+  return max_size ? max_size - 1 : 0;
+}
+
+int BtdSolver::num_goods() const {
+  int num_goods = 0;
+  for (auto it = clusters_.cbegin(), end = clusters_.cend(); it != end; ++it) {
+    num_goods += it->goods.size();
+  }
+  return num_goods;
+}
+
+int BtdSolver::num_nogoods() const {
+  int num_nogoods = 0;
+  for (auto it = clusters_.cbegin(), end = clusters_.cend(); it != end; ++it) {
+    num_nogoods += it->nogoods.size();
+  }
+  return num_nogoods;
+}
+
+int BtdSolver::num_good_hits() const {
+  return num_good_hits_;
+}
+
+Clock::Diff BtdSolver::duration() const {
+  return duration_;
+}
+
+}  // namespace ace
@@ -0,0 +1,143 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#ifndef SRC_BTD_SOLVER_H_
+#define SRC_BTD_SOLVER_H_
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "./solver.h"
+#include "./clock.h"
+#include "./assignment.h"
+
+namespace ace {
+
+// The constraint network.
+class Network;
+
+// The variable ordering.
+class VariableOrdering;
+
+// A constraint network solver based on backtracking on a tree decomposition
+// (BTD). The cluster tree is built from the elimination ordering given by the
+// reversed variable ordering. The clusters are searched along the tree and the
+// (in)consistency of a subtree is recorded for each assignment of its
+// separator as a good or nogood, which bounds the search by the induced width
+// instead of the number of variables. Searches for a single solution.
+class BtdSolver : public Solver {
+ public:
+  // Initialises the solver with the given network.
+  explicit BtdSolver(Network* network);
+
+  // Searches for a solution for the network.
+  // Returns whether it found a solution.
+  bool Solve();
+
+  // Resets the solver meta-information, which is collected during search.
+  void Reset();
+
+  // Sets the variable ordering, which determines the tree decomposition.
+  void variable_ordering(const VariableOrdering& var_ordering);
+
+  // Sets the time limit for the search. Search will be terminated if the time
+  // limit is exceeded, returning false.
+  void time_limit(const base::Clock::Diff& limit);
+
+  // Returns the set time limit.
+  base::Clock::Diff time_limit() const;
+
+  // Sets the maximum number of solutions to be searched for, only a single
+  // solution is searched for.
+  void max_num_solutions(const int num);
+
+  // Returns the set maximum number of solutions to be searched for.
+  int max_num_solutions() const;
+
+  // Returns a const reference to the solutions found by the last search.
+  const std::vector<Assignment>& solutions() const;
+
+  // Returns the duration of the last search in microseconds.
+  base::Clock::Diff duration() const;
+
+  // Returns the number of backtracks used during the last search.
+  int num_backtracks() const;
+
+  // Returns the number of states explored during the last search.
+  double num_explored_states() const;
+
+  // Returns the number of clusters of the tree decomposition.
+  int num_clusters() const;
+
+  // Returns the width of the tree decomposition, the maximum cluster size
+  // minus one.
+  int width() const;
+
+  // Returns the number of goods recorded during the last search.
+  int num_goods() const;
+
+  // Returns the number of nogoods recorded during the last search.
+  int num_nogoods() const;
+
+  // Returns the number of subtree searches saved by recorded (no)goods during
+  // the last search.
+  int num_good_hits() const;
+
+ private:
+  typedef std::vector<int> Key;
+
+  // Functor used for separator assignment hashing.
+  struct KeyHash {
+    size_t operator()(const Key& key) const;
+  };
+
+  // A cluster of the tree decomposition. Its variables are the separator
+  // shared with the parent cluster and the proper variables.
+  struct Cluster {
+    std::vector<int> separator;
+    std::vector<int> variables;
+    std::vector<int> children;
+    // The variables of the subtree rooted at this cluster, excluding the
+    // separator.
+    std::vector<int> subtree;
+    // Separator assignments and the values of the subtree extending them.
+    std::unordered_map<Key, std::vector<int>, KeyHash> goods;
+    std::unordered_set<Key, KeyHash> nogoods;
+  };
+
+  // Builds the cluster tree from the variable ordering. The first cluster is
+  // an empty root, connecting the clusters of all components.
+  void Decompose();
+
+  // Assigns the proper variables of the cluster from given index on, then
+  // solves the child clusters.
+  // Returns whether a consistent extension was found.
+  bool SolveCluster(const int cluster_id, const int index,
+                    Assignment* assignment);
+
+  // Solves the subtrees of the child clusters, using the recorded (no)goods.
+  // Returns whether all subtrees are consistent, otherwise the assignments
+  // made for the children are reverted.
+  bool SolveChildren(const int cluster_id, Assignment* assignment);
+
+  // Returns whether the constraints of the last assigned variable are satisfied
+  // by the assignment.
+  bool Consistent(const int var_id, const Assignment& assignment) const;
+
+  Network& network_;
+  std::vector<int> var_ordering_;
+  std::vector<Cluster> clusters_;
+  // The values of the current partial solution, including the values of the
+  // subtrees covered by goods.
+  std::vector<int> values_;
+  std::vector<Assignment> solutions_;
+  double num_explored_states_;
+  int num_backtracks_;
+  int num_good_hits_;
+  bool timeout_;
+  base::Clock begin_clock_;
+  base::Clock::Diff duration_;
+  base::Clock::Diff time_limit_;
+  size_t max_num_solutions_;
+};
+
+}  // namespace ace
+#endif  // SRC_BTD_SOLVER_H_
@@ -0,0 +1,127 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include "./clique-bound.h"
+#include <cassert>
+#include <algorithm>
+#include <set>
+#include <unordered_set>
+#include <vector>
+#include "./network.h"
+
+using std::vector;
+using std::set;
+using std::unordered_set;
+using std::find;
+using base::Clock;
+
+namespace ace {
+
+const int CliqueBound::kMaxNumSwaps = 1000;
+
+CliqueBound::CliqueBound(const Network& network)
+    : Preprocessor("Clique"),
+      network_(network),
+      num_iterations_(0),
+      duration_(0) {}
+
+bool CliqueBound::Preprocess() {
+  Clock beg;
+  num_iterations_ = 0;
+  clique_.clear();
+  const vector<vector<int> >& cliques = network_.all_different();
+  for (auto it = cliques.cbegin(), end = cliques.cend(); it != end; ++it) {
+    vector<int> clique = *it;
+    Improve(&clique);
+    if (clique.size() > clique_.size()) {
+      clique_ = clique;
+    }
+    if (static_cast<int>(clique.size()) > NumValues(clique)) {
+      // The clique variables can not take pairwise different values.
+      clique_ = clique;
+      duration_ = Clock() - beg;
+      return false;
+    }
+  }
+  duration_ = Clock() - beg;
+  return true;
+}
+
+void CliqueBound::Improve(vector<int>* clique) {
+  const vector<set<int> >& graph = network_.not_equal_graph();
+  const int num_vars = graph.size();
+  for (int swap = 0; swap < kMaxNumSwaps; ++swap) {
+    // Count the clique variables not adjacent to each variable and remember
+    // the last one.
+    vector<int> num_missing(num_vars, 0);
+    vector<int> missing(num_vars, -1);
+    unordered_set<int> members(clique->begin(), clique->end());
+    for (int v = 0; v < num_vars; ++v) {
+      if (members.count(v)) {
+        num_missing[v] = -1;
+        continue;
+      }
+      for (auto it = clique->cbegin(), end = clique->cend();
+           it != end && num_missing[v] < 2; ++it) {
+        if (!graph[v].count(*it)) {
+          ++num_missing[v];
+          missing[v] = *it;
+        }
+      }
+    }
+    bool improved = false;
+    // Add a variable adjacent to all clique variables.
+    for (int v = 0; v < num_vars && !improved; ++v) {
+      if (num_missing[v] == 0) {
+        clique->push_back(v);
+        improved = true;
+      }
+    }
+    // Replace a clique variable by two adjacent variables, which are adjacent
+    // to all other clique variables.
+    for (int v = 0; v < num_vars && !improved; ++v) {
+      if (num_missing[v] != 1) {
+        continue;
+      }
+      for (auto it = graph[v].upper_bound(v), end = graph[v].cend();
+           it != end && !improved; ++it) {
+        const int u = *it;
+        if (num_missing[u] == 1 && missing[u] == missing[v]) {
+          *find(clique->begin(), clique->end(), missing[v]) = v;
+          clique->push_back(u);
+          improved = true;
+        }
+      }
+    }
+    if (!improved) {
+      break;
+    }
+    ++num_iterations_;
+  }
+}
+
+int CliqueBound::NumValues(const vector<int>& variables) const {
+  unordered_set<int> values;
+  for (auto it = variables.cbegin(), end = variables.cend(); it != end; ++it) {
+    const Variable& var = network_.variable(*it);
+    const vector<int> domain = var.domain();
+    values.insert(domain.begin(), domain.end());
+  }
+  return values.size();
+}
+
+const vector<int>& CliqueBound::clique() const {
+  return clique_;
+}
+
+Clock::Diff CliqueBound::duration() const {
+  return duration_;
+}
+
+int CliqueBound::num_iterations() const {
+  return num_iterations_;
+}
+
+int CliqueBound::num_processed() const {
+  return 0;
+}
+
+}  // namespace ace
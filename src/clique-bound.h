@@ -0,0 +1,58 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#ifndef SRC_CLIQUE_BOUND_H_
+#define SRC_CLIQUE_BOUND_H_
+
+#include <vector>
+#include "./preprocessor.h"
+#include "./clock.h"
+
+namespace ace {
+
+class Network;
+
+// Clique lower bound preprocessor. Searches for large cliques of variables
+// with pairwise not-equal constraints, greedily grown from the all-different
+// cliques of the network and improved by local search. The network is
+// inconsistent if a clique has more variables than values in the union of
+// their domains.
+class CliqueBound : public Preprocessor {
+ public:
+  // The maximum number of improving swaps per clique.
+  static const int kMaxNumSwaps;
+
+  // Initializes preprocessor with given network.
+  explicit CliqueBound(const Network& network);
+
+  // Searches for a clique exceeding its domain values.
+  // Returns false if one was found, proving the network inconsistent.
+  bool Preprocess();
+
+  // Returns the largest clique found by the last call to preprocess, or the
+  // first clique exceeding its domain values.
+  const std::vector<int>& clique() const;
+
+  // Returns the duration in microseconds of the last call to preprocess.
+  base::Clock::Diff duration() const;
+
+  // Returns the number of improving swaps used by the last call to preprocess.
+  int num_iterations() const;
+
+  // Returns the number of removed values, which is always 0.
+  int num_processed() const;
+
+ private:
+  // Improves the clique by adding variables adjacent to all clique variables
+  // and by replacing one clique variable by two adjacent ones.
+  void Improve(std::vector<int>* clique);
+
+  // Returns the number of distinct values in the domains of the variables.
+  int NumValues(const std::vector<int>& variables) const;
+
+  const Network& network_;
+  std::vector<int> clique_;
+  int num_iterations_;
+  base::Clock::Diff duration_;
+};
+
+}  // namespace ace
+#endif  // SRC_CLIQUE_BOUND_H_
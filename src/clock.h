@@ -23,9 +23,14 @@ class Clock {
   static constexpr double kSecInMicro = 1.0 / kMicroInSec;
   static constexpr double kMinInMicro = 1.0 / kMicroInMin;
 
-  Clock() {
-    // clock_gettime(CLOCK_MONOTONIC, &time_);
-    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &time_);
+  // Clock types, thread time keeps the limits of concurrently running solvers
+  // apart, wall time measures parallel work.
+  static const clockid_t kProcessTime = CLOCK_PROCESS_CPUTIME_ID;
+  static const clockid_t kThreadTime = CLOCK_THREAD_CPUTIME_ID;
+  static const clockid_t kWallTime = CLOCK_MONOTONIC;
+
+  explicit Clock(const clockid_t type = kProcessTime) {
+    clock_gettime(type, &time_);
   }
 
   Diff operator-(const Clock& rhs) const {
@@ -0,0 +1,205 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include "./compact-table.h"
+#include <cassert>
+#include "./network.h"
+
+using std::vector;
+
+namespace ace {
+
+const size_t CompactTable::kMaxNumTuples = 1 << 24;
+
+CompactTable::CompactTable()
+    : conflicting_(false),
+      num_prunings_(0) {}
+
+CompactTable::CompactTable(const vector<int>& domain_sizes,
+                           const TupleTable& tuples, const bool conflicting)
+    : tuples_(tuples),
+      conflicting_(conflicting),
+      valid_(tuples.size()),
+      sizes_(domain_sizes),
+      num_prunings_(0) {
+  const int arity = domain_sizes.size();
+  assert(tuples_.empty() || tuples_.arity() == arity);
+  assert(!conflicting_ || !tuples_.wildcards());
+  const int num_words = valid_.num_words();
+  supports_.resize(arity);
+  residues_.resize(arity);
+  for (int i = 0; i < arity; ++i) {
+    supports_[i].assign(domain_sizes[i], vector<uint64_t>(num_words, 0));
+    residues_[i].assign(domain_sizes[i], 0);
+  }
+  for (int t = 0, size = tuples_.size(); t < size; ++t) {
+    const int* tuple = tuples_.tuple(t);
+    const uint64_t bit = uint64_t(1) << (t % 64);
+    for (int i = 0; i < arity; ++i) {
+      if (tuple[i] == TupleTable::kAny) {
+        // A wildcard supports every value.
+        for (int v = 0; v < domain_sizes[i]; ++v) {
+          supports_[i][v][t / 64] |= bit;
+        }
+      } else {
+        assert(tuple[i] >= 0 && tuple[i] < domain_sizes[i]);
+        supports_[i][tuple[i]][t / 64] |= bit;
+      }
+    }
+  }
+}
+
+void CompactTable::StartTransaction() {
+  valid_.StartTransaction();
+  transactions_.push_back(false);
+}
+
+void CompactTable::CommitTransaction() {
+  valid_.CommitTransaction();
+  assert(transactions_.size());
+  if (transactions_.back()) {
+    assert(size_snapshots_.size());
+    size_snapshots_.pop_back();
+  }
+  transactions_.pop_back();
+}
+
+void CompactTable::RollbackTransaction() {
+  valid_.RollbackTransaction();
+  assert(transactions_.size());
+  if (transactions_.back()) {
+    assert(size_snapshots_.size());
+    sizes_.swap(size_snapshots_.back());
+    size_snapshots_.pop_back();
+  }
+  transactions_.pop_back();
+}
+
+void CompactTable::SaveSizes() {
+  if (transactions_.size() && !transactions_.back()) {
+    // We have not made a snapshot during this transaction yet.
+    size_snapshots_.push_back(sizes_);
+    transactions_.back() = true;
+  }
+}
+
+bool CompactTable::Supports(const vector<int>& values) const {
+  return tuples_.Matches(values) != conflicting_;
+}
+
+bool CompactTable::Propagate(const vector<int>& scope, Network* network,
+                             vector<int>* reduced) {
+  // Without valid conflicting tuples the constraint is entailed.
+  if (valid_.empty()) {
+    return conflicting_;
+  }
+  // Remove the tuples invalidated by the domain reductions since the last
+  // propagation. Domains only shrink within a transaction, so a changed size
+  // identifies a reduced domain.
+  const int arity = scope.size();
+  assert(arity == static_cast<int>(sizes_.size()));
+  vector<vector<int> > domains(arity);
+  for (int i = 0; i < arity; ++i) {
+    domains[i] = network->variable(scope[i]).valid_value_ids();
+    const int size = domains[i].size();
+    if (size == 0) {
+      return false;
+    }
+    if (size == sizes_[i]) {
+      continue;
+    }
+    SaveSizes();
+    sizes_[i] = size;
+    valid_.ClearMask();
+    for (auto it = domains[i].cbegin(), end = domains[i].cend();
+         it != end; ++it) {
+      valid_.AddToMask(supports_[i][*it]);
+    }
+    valid_.IntersectWithMask();
+    if (valid_.empty()) {
+      return conflicting_;
+    }
+  }
+  if (conflicting_) {
+    return FilterConflicts(scope, domains, network, reduced);
+  }
+  // Remove the values without a valid supporting tuple.
+  for (int i = 0; i < arity; ++i) {
+    Variable& var = network->variable(scope[i]);
+    int num_removed = 0;
+    for (auto it = domains[i].cbegin(), end = domains[i].cend();
+         it != end; ++it) {
+      const int value = *it;
+      const vector<uint64_t>& supports = supports_[i][value];
+      int& residue = residues_[i][value];
+      if (valid_.word(residue) & supports[residue]) {
+        continue;
+      }
+      const int index = valid_.IntersectIndex(supports);
+      if (index != -1) {
+        residue = index;
+      } else {
+        var.RemoveValue(value);
+        ++num_removed;
+      }
+    }
+    if (num_removed) {
+      SaveSizes();
+      sizes_[i] -= num_removed;
+      num_prunings_ += num_removed;
+      reduced->push_back(scope[i]);
+    }
+  }
+  return true;
+}
+
+bool CompactTable::FilterConflicts(const vector<int>& scope,
+                                   const vector<vector<int> >& domains,
+                                   Network* network, vector<int>* reduced) {
+  // Removing a value whose combinations all conflict does not change the
+  // coverage of the other values, so the counts for the domains at the start
+  // of the filtering remain exact.
+  const int arity = scope.size();
+  const uint64_t num_tuples = tuples_.size();
+  for (int i = 0; i < arity; ++i) {
+    // The number of combinations of the other domains, values are only
+    // covered if it does not exceed the number of tuples.
+    uint64_t num_combinations = 1;
+    for (int j = 0; j < arity && num_combinations <= num_tuples; ++j) {
+      if (j != i) {
+        num_combinations *= domains[j].size();
+      }
+    }
+    if (num_combinations > num_tuples) {
+      continue;
+    }
+    Variable& var = network->variable(scope[i]);
+    int num_removed = 0;
+    for (auto it = domains[i].cbegin(), end = domains[i].cend();
+         it != end; ++it) {
+      const int value = *it;
+      if (valid_.IntersectCount(supports_[i][value]) == num_combinations) {
+        var.RemoveValue(value);
+        ++num_removed;
+      }
+    }
+    if (num_removed) {
+      // The recorded domain size is kept, the tuples with the removed values
+      // are still valid and get removed at the next propagation.
+      num_prunings_ += num_removed;
+      reduced->push_back(scope[i]);
+      if (num_removed == static_cast<int>(domains[i].size())) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+int CompactTable::num_tuples() const {
+  return tuples_.size();
+}
+
+int CompactTable::num_prunings() const {
+  return num_prunings_;
+}
+
+}  // namespace ace
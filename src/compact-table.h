@@ -0,0 +1,85 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#ifndef SRC_COMPACT_TABLE_H_
+#define SRC_COMPACT_TABLE_H_
+
+#include <cstdint>
+#include <vector>
+#include "./sparse-bitset.h"
+#include "./tuple-table.h"
+
+namespace ace {
+
+class Network;
+
+// A table of supported or conflicting value id tuples for a constraint of any
+// arity, with generalised arc-consistency propagation by Compact-Table. The
+// tuples which are valid for the current domains are kept in a reversible
+// sparse bitset. Supporting wildcard tuples are kept as they are and support
+// every value at their wildcard positions. A value is supported by a
+// conflicting table unless its valid tuples cover all combinations of the other
+// domains, which are counted.
+class CompactTable {
+ public:
+  // The maximum number of conflicting tuples after wildcard expansion.
+  static const size_t kMaxNumTuples;
+
+  // Initialises an empty table.
+  CompactTable();
+
+  // Initialises the table for variables of given domain sizes with given
+  // value id tuples, which are supporting and may contain wildcards or are
+  // conflicting and contain no wildcards.
+  CompactTable(const std::vector<int>& domain_sizes, const TupleTable& tuples,
+               const bool conflicting);
+
+  // Starts a transaction. All modifications are recorded and reversable
+  // during the transaction.
+  void StartTransaction();
+
+  // Commits the transaction making the modifications persistent.
+  void CommitTransaction();
+
+  // Rolls back all modifications of the currently active transaction.
+  void RollbackTransaction();
+
+  // Returns whether the given value id tuple is supported.
+  bool Supports(const std::vector<int>& values) const;
+
+  // Removes the values of the given scope variables without a support. Adds
+  // the ids of the reduced variables.
+  // Returns false if the constraint cannot be satisfied anymore.
+  bool Propagate(const std::vector<int>& scope, Network* network,
+                 std::vector<int>* reduced);
+
+  // Returns the number of tuples.
+  int num_tuples() const;
+
+  // Returns the total number of values removed by propagation.
+  int num_prunings() const;
+
+ private:
+  // Records the domain sizes at the start of a transaction.
+  void SaveSizes();
+
+  // Removes the values covered by the valid conflicting tuples.
+  // Returns false if a domain is wiped out.
+  bool FilterConflicts(const std::vector<int>& scope,
+                       const std::vector<std::vector<int> >& domains,
+                       Network* network, std::vector<int>* reduced);
+
+  TupleTable tuples_;
+  bool conflicting_;
+  // The tuples with each value (by scope index and value id).
+  std::vector<std::vector<std::vector<uint64_t> > > supports_;
+  // The last word found to hold a support for each value.
+  std::vector<std::vector<int> > residues_;
+  SparseBitset valid_;
+  // The domain sizes the valid tuples were last updated for.
+  std::vector<int> sizes_;
+  std::vector<bool> transactions_;
+  std::vector<std::vector<int> > size_snapshots_;
+  int num_prunings_;
+};
+
+}  // namespace ace
+#endif  // SRC_COMPACT_TABLE_H_
@@ -0,0 +1,371 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include "./component-solver.h"
+#include <cassert>
+#include <chrono>
+#include <set>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include "./clock.h"
+#include "./fixed-ordering.h"
+#include "./network.h"
+#include "./variable-ordering.h"
+
+using std::vector;
+using std::set;
+using std::thread;
+using std::mutex;
+using std::lock_guard;
+using std::min;
+using std::max;
+using std::sort;
+using std::stable_sort;
+using std::numeric_limits;
+using base::Clock;
+
+namespace ace {
+
+// Orders components by decreasing size, the largest ones are solved first.
+struct ComponentGreater {
+  bool operator()(const vector<int>& lhs, const vector<int>& rhs) const {
+    return lhs.size() > rhs.size();
+  }
+};
+
+ComponentSolver::Component::Component(const Network& root,
+                                      const vector<int>& variables)
+    : variables(variables),
+      network(root.Subnetwork(variables)),
+      solver(&network),
+      sink(nullptr) {}
+
+ComponentSolver::Component::~Component() {
+  delete sink;
+}
+
+ComponentSolver::ComponentSolver(const Network& network,
+                                 const int num_workers)
+    : Solver(),
+      network_(network),
+      num_workers_(num_workers),
+      next_component_(0),
+      done_(false),
+      begin_clock_(Clock::kWallTime),
+      time_limit_(Solver::kDefTimeLimit),
+      max_num_solutions_(Solver::kDefMaxNumSolutions) {
+  assert(num_workers > 0);
+  // Collect the connected components of the primal graph.
+  const int num_vars = network_.num_variables();
+  const vector<set<int> > graph = VariableOrdering::PrimalGraph(network_);
+  vector<vector<int> > components;
+  vector<bool> visited(num_vars, false);
+  for (int i = 0; i < num_vars; ++i) {
+    if (visited[i]) {
+      continue;
+    }
+    components.push_back(vector<int>(1, i));
+    vector<int>& component = components.back();
+    visited[i] = true;
+    for (size_t j = 0; j < component.size(); ++j) {
+      const set<int>& neighs = graph[component[j]];
+      for (auto it = neighs.cbegin(), end = neighs.cend(); it != end; ++it) {
+        if (!visited[*it]) {
+          visited[*it] = true;
+          component.push_back(*it);
+        }
+      }
+    }
+    // Keep the lexicographical variable ordering within the component.
+    sort(component.begin(), component.end());
+  }
+  stable_sort(components.begin(), components.end(), ComponentGreater());
+  for (auto it = components.cbegin(), end = components.cend();
+       it != end; ++it) {
+    components_.push_back(new Component(network_, *it));
+  }
+  Reset();
+}
+
+ComponentSolver::~ComponentSolver() {
+  for (auto it = components_.begin(), end = components_.end();
+       it != end; ++it) {
+    delete *it;
+  }
+}
+
+bool ComponentSolver::Solve() {
+  Reset();
+  begin_clock_ = Clock(Clock::kWallTime);
+  solutions_.clear();
+  num_solutions_ = 0;
+  solution_count_ = 0.0;
+  done_ = false;
+  next_component_ = 0;
+  const bool all = max_num_solutions_ >=
+                   static_cast<size_t>(Solver::kDefMaxNumSolutions);
+  const bool count_only = all && CountOnly();
+  for (auto it = components_.begin(), end = components_.end();
+       it != end; ++it) {
+    Component* component = *it;
+    delete component->sink;
+    // The solutions of the components are only counted when searching for
+    // all solutions without streaming them.
+    component->sink = count_only ? new FirstSolutionSink() : nullptr;
+    component->solver.solution_sink(component->sink);
+    component->solver.max_num_solutions(all ? 0 : max_num_solutions_);
+  }
+
+  const int num_threads = max(min<int>(num_workers_, components_.size()), 1);
+  num_running_ = num_threads;
+  vector<thread> threads;
+  threads.reserve(num_threads);
+  for (int w = 0; w < num_threads; ++w) {
+    threads.push_back(thread(&ComponentSolver::Run, this));
+  }
+  {
+    // The time limit is enforced in wall time here.
+    std::unique_lock<mutex> lock(running_mutex_);
+    auto all_finished = [this] { return num_running_ == 0; };
+    if (time_limit_ >= Solver::kMaxWaitTime) {
+      finished_.wait(lock, all_finished);
+    } else if (!finished_.wait_for(lock,
+                                   std::chrono::microseconds(time_limit_),
+                                   all_finished)) {
+      lock.unlock();
+      Stop();
+    }
+  }
+  for (auto it = threads.begin(), end = threads.end(); it != end; ++it) {
+    it->join();
+  }
+  Merge();
+  duration_ = Clock(Clock::kWallTime) - begin_clock_;
+  return num_solutions_;
+}
+
+void ComponentSolver::Run() {
+  const int num_components = components_.size();
+  while (!done_) {
+    const int c = next_component_++;
+    if (c >= num_components) {
+      // All components are taken.
+      break;
+    }
+    const Clock::Diff elapsed = Clock(Clock::kWallTime) - begin_clock_;
+    if (cancelled_ || elapsed > time_limit_) {
+      // Time limit reached or search cancelled.
+      done_ = true;
+      break;
+    }
+    if (!components_[c]->solver.Solve()) {
+      // A component without solutions leaves the network without solutions.
+      Stop();
+    }
+  }
+  lock_guard<mutex> lock(running_mutex_);
+  --num_running_;
+  finished_.notify_one();
+}
+
+void ComponentSolver::Stop() {
+  done_ = true;
+  for (auto it = components_.begin(), end = components_.end();
+       it != end; ++it) {
+    (*it)->solver.Cancel();
+  }
+}
+
+void ComponentSolver::Merge() {
+  const int num_components = components_.size();
+  vector<int64_t> counts(num_components, 0);
+  solution_count_ = 1.0;
+  for (int c = 0; c < num_components; ++c) {
+    counts[c] = NumSolutions(*components_[c]);
+    solution_count_ *= counts[c];
+  }
+  if (!solution_count_) {
+    return;
+  }
+  const bool count_only = max_num_solutions_ >=
+                          static_cast<size_t>(Solver::kDefMaxNumSolutions) &&
+                          CountOnly();
+  // Enumerate the combinations of the component solutions, when only counting
+  // all solutions only the first one is used.
+  vector<int> indices(num_components, 0);
+  while (num_solutions_ < max_num_solutions_) {
+    Assignment assignment(network_);
+    for (int c = 0; c < num_components; ++c) {
+      const Component& component = *components_[c];
+      const Assignment& solution = component.sink ? *component.sink->first() :
+                                   component.solver.solutions()[indices[c]];
+      const int size = component.variables.size();
+      for (int i = 0; i < size; ++i) {
+        assignment.Assign(component.variables[i], solution.value(i));
+      }
+    }
+    assert(assignment.Complete() && assignment.Consistent());
+    AddSolution(assignment, &solutions_);
+    if (count_only) {
+      // The remaining solutions are only counted.
+      num_solutions_ = min<double>(solution_count_,
+                                   Solver::kDefMaxNumSolutions);
+      if (sink_) {
+        const int64_t max_count = numeric_limits<int64_t>::max();
+        sink_->AddCount((solution_count_ >= max_count ? max_count :
+                         static_cast<int64_t>(solution_count_)) - 1);
+      }
+      break;
+    }
+    // Advance to the next combination.
+    int c = 0;
+    while (c < num_components && ++indices[c] == counts[c]) {
+      indices[c++] = 0;
+    }
+    if (c == num_components) {
+      break;
+    }
+  }
+}
+
+bool ComponentSolver::CountOnly() const {
+  return !sink_ || sink_->counting();
+}
+
+int64_t ComponentSolver::NumSolutions(const Component& component) const {
+  return component.sink ? component.sink->num_solutions() :
+                          component.solver.num_solutions();
+}
+
+void ComponentSolver::Cancel() {
+  Solver::Cancel();
+  for (auto it = components_.begin(), end = components_.end();
+       it != end; ++it) {
+    (*it)->solver.Cancel();
+  }
+}
+
+void ComponentSolver::Reset() {
+  duration_ = 0;
+  for (auto it = components_.begin(), end = components_.end();
+       it != end; ++it) {
+    (*it)->solver.Reset();
+  }
+}
+
+void ComponentSolver::variable_ordering(const VariableOrdering& var_ordering) {
+  const vector<int> ordering = var_ordering.CreateOrdering();
+  const int num_vars = network_.num_variables();
+  // The component variable id of each root variable.
+  vector<int> ids(num_vars, 0);
+  for (auto it = components_.cbegin(), end = components_.cend();
+       it != end; ++it) {
+    const vector<int>& variables = (*it)->variables;
+    for (int i = 0, size = variables.size(); i < size; ++i) {
+      ids[variables[i]] = i;
+    }
+  }
+  vector<vector<int> > orderings(components_.size());
+  vector<int> component_ids(num_vars, 0);
+  for (int c = 0, size = components_.size(); c < size; ++c) {
+    const vector<int>& variables = components_[c]->variables;
+    for (auto it = variables.cbegin(), end = variables.cend();
+         it != end; ++it) {
+      component_ids[*it] = c;
+    }
+  }
+  for (auto it = ordering.cbegin(), end = ordering.cend(); it != end; ++it) {
+    orderings[component_ids[*it]].push_back(ids[*it]);
+  }
+  for (int c = 0, size = components_.size(); c < size; ++c) {
+    components_[c]->solver.variable_ordering(FixedOrdering(orderings[c]));
+  }
+}
+
+void ComponentSolver::restart_cutoff(const int cutoff) {
+  for (auto it = components_.begin(), end = components_.end();
+       it != end; ++it) {
+    (*it)->solver.restart_cutoff(cutoff);
+  }
+}
+
+void ComponentSolver::all_different_propagation(const bool enabled) {
+  for (auto it = components_.begin(), end = components_.end();
+       it != end; ++it) {
+    (*it)->solver.all_different_propagation(enabled);
+  }
+}
+
+void ComponentSolver::value_symmetry_breaking(const bool enabled) {
+  for (auto it = components_.begin(), end = components_.end();
+       it != end; ++it) {
+    (*it)->solver.value_symmetry_breaking(enabled);
+  }
+}
+
+void ComponentSolver::max_num_nogood_literals(const int num) {
+  for (auto it = components_.begin(), end = components_.end();
+       it != end; ++it) {
+    (*it)->solver.max_num_nogood_literals(num);
+  }
+}
+
+void ComponentSolver::time_limit(const Clock::Diff& limit) {
+  time_limit_ = min(limit, Solver::kDefTimeLimit);
+}
+
+Clock::Diff ComponentSolver::time_limit() const {
+  return time_limit_;
+}
+
+void ComponentSolver::max_num_solutions(const int num) {
+  max_num_solutions_ = num > 0 ? num : Solver::kDefMaxNumSolutions;
+}
+
+int ComponentSolver::max_num_solutions() const {
+  return max_num_solutions_;
+}
+
+const vector<Assignment>& ComponentSolver::solutions() const {
+  return solutions_;
+}
+
+double ComponentSolver::num_explored_states() const {
+  double num_explored_states = 0.0;
+  for (auto it = components_.cbegin(), end = components_.cend();
+       it != end; ++it) {
+    num_explored_states += (*it)->solver.num_explored_states();
+  }
+  return num_explored_states;
+}
+
+int ComponentSolver::num_backtracks() const {
+  int num_backtracks = 0;
+  for (auto it = components_.cbegin(), end = components_.cend();
+       it != end; ++it) {
+    num_backtracks += (*it)->solver.num_backtracks();
+  }
+  return num_backtracks;
+}
+
+double ComponentSolver::solution_count() const {
+  return solution_count_;
+}
+
+int ComponentSolver::num_components() const {
+  return components_.size();
+}
+
+int ComponentSolver::max_component_size() const {
+  return components_.size() ? components_.front()->variables.size() : 0;
+}
+
+int ComponentSolver::num_workers() const {
+  return num_workers_;
+}
+
+Clock::Diff ComponentSolver::duration() const {
+  return duration_;
+}
+
+}  // namespace ace
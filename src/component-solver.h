@@ -0,0 +1,153 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#ifndef SRC_COMPONENT_SOLVER_H_
+#define SRC_COMPONENT_SOLVER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+#include "./solver.h"
+#include "./clock.h"
+#include "./assignment.h"
+#include "./network.h"
+#include "./backtrack-solver.h"
+#include "./solution-sink.h"
+
+namespace ace {
+
+// The variable ordering.
+class VariableOrdering;
+
+// A constraint network solver which splits the network into the connected
+// components of its primal graph. Each component is solved independently by
+// backtracking with arc-consistency look-ahead, several components are solved
+// concurrently. The solutions are merged, the number of solutions is the
+// product of the component solution counts, without enumerating the product
+// when searching for all solutions.
+class ComponentSolver : public Solver {
+ public:
+  // Initialises the solver with the given network and number of workers.
+  ComponentSolver(const Network& network, const int num_workers);
+
+  // Deletes the components.
+  ~ComponentSolver();
+
+  // Searches for a solution for the network.
+  // Returns whether it found a solution.
+  bool Solve();
+
+  // Cancels the search, including the running component searches.
+  void Cancel();
+
+  // Resets the solver meta-information, which is collected during search.
+  void Reset();
+
+  // Sets the variable ordering, which is restricted to each component.
+  void variable_ordering(const VariableOrdering& var_ordering);
+
+  // Sets the number of backtracks before the first restart of each component
+  // search (0 disables restarts).
+  void restart_cutoff(const int cutoff);
+
+  // Sets whether the all-different constraints of each component are
+  // propagated by matching alongside arc-consistency.
+  void all_different_propagation(const bool enabled);
+
+  // Sets whether the symmetry of interchangeable values is broken during each
+  // component search.
+  void value_symmetry_breaking(const bool enabled);
+
+  // Sets the maximum number of literals stored in the nogood base of each
+  // component search.
+  void max_num_nogood_literals(const int num);
+
+  // Sets the time limit for the search, measured in wall time. Search will be
+  // terminated if the time limit is exceeded, returning false.
+  void time_limit(const base::Clock::Diff& limit);
+
+  // Returns the set time limit.
+  base::Clock::Diff time_limit() const;
+
+  // Sets the maximum number of solutions to be searched for. When searching
+  // for all solutions, only the first merged solution is kept and the others
+  // are counted, unless they are streamed to a non-counting sink.
+  void max_num_solutions(const int num);
+
+  // Returns the set maximum number of solutions to be searched for.
+  int max_num_solutions() const;
+
+  // Returns a const reference to the solutions found by the last search.
+  const std::vector<Assignment>& solutions() const;
+
+  // Returns the wall time duration of the last search in microseconds.
+  base::Clock::Diff duration() const;
+
+  // Returns the number of backtracks over all components during the last
+  // search.
+  int num_backtracks() const;
+
+  // Returns the number of states explored during the last search.
+  double num_explored_states() const;
+
+  // Returns the product of the component solution counts of the last search.
+  double solution_count() const;
+
+  // Returns the number of connected components.
+  int num_components() const;
+
+  // Returns the number of variables of the largest component.
+  int max_component_size() const;
+
+  // Returns the number of workers.
+  int num_workers() const;
+
+ private:
+  // A connected component with its own network and solver.
+  struct Component {
+    Component(const Network& root, const std::vector<int>& variables);
+
+    // Deletes the sink.
+    ~Component();
+
+    // The variable ids in the root network, by component variable id.
+    std::vector<int> variables;
+    Network network;
+    BacktrackSolver solver;
+    // Counts the solutions when only counting all solutions.
+    FirstSolutionSink* sink;
+  };
+
+  // The search loop of a worker, solving the components until all are taken.
+  void Run();
+
+  // Stops the running component searches, no further components are taken.
+  void Stop();
+
+  // Merges the component solutions into solutions of the network.
+  void Merge();
+
+  // Returns whether all solutions are only counted instead of enumerated,
+  // which is the case unless they are streamed to a non-counting sink.
+  bool CountOnly() const;
+
+  // Returns the number of solutions found for the component.
+  int64_t NumSolutions(const Component& component) const;
+
+  const Network& network_;
+  std::vector<Component*> components_;
+  std::vector<Assignment> solutions_;
+  int num_workers_;
+  std::mutex running_mutex_;
+  std::condition_variable finished_;
+  int num_running_;
+  std::atomic<int> next_component_;
+  std::atomic<bool> done_;
+  double solution_count_;
+  base::Clock begin_clock_;
+  base::Clock::Diff duration_;
+  base::Clock::Diff time_limit_;
+  size_t max_num_solutions_;
+};
+
+}  // namespace ace
+#endif  // SRC_COMPONENT_SOLVER_H_
@@ -0,0 +1,198 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include "./conflict-table.h"
+#include <cassert>
+#include <vector>
+#include <algorithm>
+#include "./assignment.h"
+#include "./network.h"
+
+using std::vector;
+using std::fill;
+using std::max;
+
+namespace ace {
+
+ConflictTable::ConflictTable(const Network& network)
+    : network_(network),
+      weights_(network.num_constraints(), 1),
+      violated_index_(network.num_constraints(), -1),
+      violated_weight_(0),
+      max_weight_(1) {
+  const int num_vars = network_.num_variables();
+  domains_.resize(num_vars);
+  offsets_.resize(num_vars + 1, 0);
+  for (int v = 0; v < num_vars; ++v) {
+    const Variable& var = network_.variable(v);
+    domains_[v] = var.valid_value_ids();
+    offsets_[v + 1] = offsets_[v] + var.num_values();
+  }
+  conflicts_.resize(offsets_.back(), 0);
+  values_.resize(num_vars, 0);
+}
+
+void ConflictTable::Init(const Assignment& assignment) {
+  assert(assignment.Complete());
+  const int num_vars = network_.num_variables();
+  for (int v = 0; v < num_vars; ++v) {
+    values_[v] = assignment.value(v);
+  }
+  Recount();
+}
+
+void ConflictTable::Recount() {
+  fill(conflicts_.begin(), conflicts_.end(), 0);
+  violated_.clear();
+  fill(violated_index_.begin(), violated_index_.end(), -1);
+  violated_weight_ = 0;
+  const int num_constraints = network_.num_constraints();
+  for (int c = 0; c < num_constraints; ++c) {
+    const Constraint& constraint = network_.constraint(c);
+    const int arity = constraint.arity();
+    const int weight = weights_[c];
+    for (int i = 0; i < arity; ++i) {
+      const int var_id = constraint.scope(i);
+      const vector<int>& domain = domains_[var_id];
+      for (auto it = domain.cbegin(), end = domain.cend(); it != end; ++it) {
+        if (Violated(c, i, *it)) {
+          conflicts_[offsets_[var_id] + *it] += weight;
+        }
+      }
+    }
+    UpdateViolated(c);
+  }
+}
+
+void ConflictTable::Flip(const int variable, const int value) {
+  const int old_value = values_[variable];
+  if (old_value == value) {
+    return;
+  }
+  // The counts of the flipped variable do not depend on its own value, only
+  // those of its neighbours change.
+  const vector<int>& constraints = network_.constraints(variable);
+  for (auto it = constraints.cbegin(), end = constraints.cend();
+       it != end; ++it) {
+    const int constraint_id = *it;
+    const Constraint& constraint = network_.constraint(constraint_id);
+    const int arity = constraint.arity();
+    const int weight = weights_[constraint_id];
+    for (int i = 0; i < arity; ++i) {
+      const int var_id = constraint.scope(i);
+      if (var_id == variable) {
+        continue;
+      }
+      const vector<int>& domain = domains_[var_id];
+      int* conflicts = &conflicts_[offsets_[var_id]];
+      for (auto it2 = domain.cbegin(), end2 = domain.cend();
+           it2 != end2; ++it2) {
+        conflicts[*it2] -= weight * Violated(constraint_id, i, *it2);
+      }
+      values_[variable] = value;
+      for (auto it2 = domain.cbegin(), end2 = domain.cend();
+           it2 != end2; ++it2) {
+        conflicts[*it2] += weight * Violated(constraint_id, i, *it2);
+      }
+      values_[variable] = old_value;
+    }
+  }
+  values_[variable] = value;
+  for (auto it = constraints.cbegin(), end = constraints.cend();
+       it != end; ++it) {
+    UpdateViolated(*it);
+  }
+}
+
+int ConflictTable::Score(const int variable, const int value) const {
+  return violated_weight_ - conflicts(variable, values_[variable]) +
+         conflicts(variable, value);
+}
+
+void ConflictTable::IncreaseWeight(const int constraint_id) {
+  const Constraint& constraint = network_.constraint(constraint_id);
+  const int arity = constraint.arity();
+  for (int i = 0; i < arity; ++i) {
+    const int var_id = constraint.scope(i);
+    const vector<int>& domain = domains_[var_id];
+    int* conflicts = &conflicts_[offsets_[var_id]];
+    for (auto it = domain.cbegin(), end = domain.cend(); it != end; ++it) {
+      conflicts[*it] += Violated(constraint_id, i, *it);
+    }
+  }
+  if (violated_index_[constraint_id] != -1) {
+    ++violated_weight_;
+  }
+  max_weight_ = max(max_weight_, ++weights_[constraint_id]);
+}
+
+void ConflictTable::DecayWeights() {
+  for (auto it = weights_.begin(), end = weights_.end(); it != end; ++it) {
+    *it = max(1, *it / 2);
+  }
+  max_weight_ = max(1, max_weight_ / 2);
+  Recount();
+}
+
+bool ConflictTable::Violated(const int constraint_id, const int scope_index,
+                             const int value) const {
+  const Constraint& constraint = network_.constraint(constraint_id);
+  const int arity = constraint.arity();
+  tuple_.resize(arity);
+  for (int i = 0; i < arity; ++i) {
+    tuple_[i] = i == scope_index ? value : values_[constraint.scope(i)];
+  }
+  return constraint.Conflicts(tuple_);
+}
+
+void ConflictTable::UpdateViolated(const int constraint_id) {
+  const int var_id = network_.constraint(constraint_id).scope(0);
+  const bool violated = Violated(constraint_id, 0, values_[var_id]);
+  int& index = violated_index_[constraint_id];
+  if (violated && index == -1) {
+    index = violated_.size();
+    violated_.push_back(constraint_id);
+    violated_weight_ += weights_[constraint_id];
+  } else if (!violated && index != -1) {
+    violated_weight_ -= weights_[constraint_id];
+    // Swap with the last violated constraint for constant time removal.
+    const int last = violated_.back();
+    violated_[index] = last;
+    violated_index_[last] = index;
+    violated_.pop_back();
+    index = -1;
+  }
+}
+
+int ConflictTable::conflicts(const int variable, const int value) const {
+  assert(offsets_[variable] + value < offsets_[variable + 1]);
+  return conflicts_[offsets_[variable] + value];
+}
+
+int ConflictTable::weight(const int constraint_id) const {
+  return weights_[constraint_id];
+}
+
+int ConflictTable::max_weight() const {
+  return max_weight_;
+}
+
+int ConflictTable::violated_weight() const {
+  return violated_weight_;
+}
+
+int ConflictTable::value(const int variable) const {
+  return values_[variable];
+}
+
+const vector<int>& ConflictTable::domain(const int variable) const {
+  return domains_[variable];
+}
+
+const vector<int>& ConflictTable::violated_constraints() const {
+  return violated_;
+}
+
+int ConflictTable::num_violated_constraints() const {
+  return violated_.size();
+}
+
+}  // namespace ace
@@ -0,0 +1,91 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#ifndef SRC_CONFLICT_TABLE_H_
+#define SRC_CONFLICT_TABLE_H_
+
+#include <vector>
+
+namespace ace {
+
+class Network;
+class Assignment;
+
+// Incremental conflict counts for local search on a complete assignment. For
+// each variable-value pair it keeps the weighted number of constraints that
+// would be violated if the variable took the value, with all other variables
+// at their current values. The violated constraints are kept in an indexed
+// set. Both are updated in O(degree * domain size) per flip. All constraint
+// weights are 1 unless increased.
+class ConflictTable {
+ public:
+  // Initialises the table for the given network, using the currently valid
+  // values of its variables.
+  explicit ConflictTable(const Network& network);
+
+  // Initialises the counts for the given complete assignment.
+  void Init(const Assignment& assignment);
+
+  // Changes the value (by id) of the variable and updates the counts.
+  void Flip(const int variable, const int value);
+
+  // Returns the weighted number of violated constraints after changing the
+  // value (by id) of the variable.
+  int Score(const int variable, const int value) const;
+
+  // Increases the weight of the constraint by one.
+  void IncreaseWeight(const int constraint_id);
+
+  // Halves all constraint weights, keeping them at least 1.
+  void DecayWeights();
+
+  // Returns the weighted number of constraints of the variable, which would
+  // be violated with given value (by id).
+  int conflicts(const int variable, const int value) const;
+
+  // Returns the weight of the constraint.
+  int weight(const int constraint_id) const;
+
+  // Returns the maximum constraint weight.
+  int max_weight() const;
+
+  // Returns the weighted number of currently violated constraints.
+  int violated_weight() const;
+
+  // Returns the current value (by id) of the variable.
+  int value(const int variable) const;
+
+  // Returns a const reference to the valid values (by id) of the variable.
+  const std::vector<int>& domain(const int variable) const;
+
+  // Returns a const reference to the currently violated constraints.
+  const std::vector<int>& violated_constraints() const;
+
+  // Returns the number of currently violated constraints.
+  int num_violated_constraints() const;
+
+ private:
+  // Returns whether the constraint is violated with the current values, but
+  // with the variable at given scope index set to value.
+  bool Violated(const int constraint_id, const int scope_index,
+                const int value) const;
+
+  // Updates the violated constraints set for the constraint.
+  void UpdateViolated(const int constraint_id);
+
+  // Recomputes the conflict counts and violations for the current values.
+  void Recount();
+
+  const Network& network_;
+  std::vector<std::vector<int> > domains_;
+  std::vector<int> offsets_;
+  std::vector<int> conflicts_;
+  std::vector<int> weights_;
+  std::vector<int> values_;
+  std::vector<int> violated_;
+  std::vector<int> violated_index_;
+  int violated_weight_;
+  int max_weight_;
+  mutable std::vector<int> tuple_;
+};
+
+}  // namespace ace
+#endif  // SRC_CONFLICT_TABLE_H_
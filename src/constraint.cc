@@ -1,11 +1,17 @@
 // Copyright 2012 Eugen Sawin <esawin@me73.com>
 #include "./constraint.h"
 #include <cassert>
+#include <cstdlib>
+#include <iostream>
 #include "./network.h"
 #include "./relation.h"
+#include "./compact-table.h"
+#include "./tuple-table.h"
 
 using std::string;
 using std::vector;
+using std::unordered_map;
+using std::cout;
 
 namespace ace {
 
@@ -14,9 +20,71 @@ Constraint::MatrixCache Constraint::matrix_cache_;
 Constraint::Constraint(const string& name, const int relation_id,
                        const vector<int>& scope, const Network& network)
     : scope_(scope),
+      matrix_offset_(0),
+      table_(nullptr),
       relation_id_(relation_id),
       name_(name) {
-  InitMatrix(network);
+  if (scope_.size() == 2) {
+    InitMatrix(network);
+  } else {
+    InitTable(network);
+  }
+}
+
+Constraint::Constraint(const Constraint& constraint)
+    : scope_(constraint.scope_),
+      matrix_(constraint.matrix_),
+      matrix_offset_(constraint.matrix_offset_),
+      table_(constraint.table_ ?
+             new CompactTable(*constraint.table_) : nullptr),
+      relation_id_(constraint.relation_id_),
+      name_(constraint.name_) {}
+
+Constraint::Constraint(const Constraint& constraint, const vector<int>& scope)
+    : scope_(scope),
+      matrix_(constraint.matrix_),
+      matrix_offset_(constraint.matrix_offset_),
+      table_(constraint.table_ ?
+             new CompactTable(*constraint.table_) : nullptr),
+      relation_id_(constraint.relation_id_),
+      name_(constraint.name_) {
+  assert(scope_.size() == constraint.scope_.size());
+}
+
+Constraint& Constraint::operator=(const Constraint& constraint) {
+  if (this != &constraint) {
+    CompactTable* table = constraint.table_ ?
+                          new CompactTable(*constraint.table_) : nullptr;
+    delete table_;
+    table_ = table;
+    scope_ = constraint.scope_;
+    matrix_ = constraint.matrix_;
+    matrix_offset_ = constraint.matrix_offset_;
+    relation_id_ = constraint.relation_id_;
+    name_ = constraint.name_;
+  }
+  return *this;
+}
+
+Constraint::~Constraint() {
+  delete table_;
+}
+
+void Constraint::Conjoin(const Constraint& constraint) {
+  assert(arity() == 2 && constraint.arity() == 2);
+  const bool reversed = constraint.scope(0) != scope_[0];
+  assert(constraint.scope(reversed) == scope_[0] &&
+         constraint.scope(!reversed) == scope_[1]);
+  const int size = matrix_.size();
+  vector<int> values(2);
+  for (int i = 0; i < size; ++i) {
+    if (matrix_[i]) {
+      values[reversed] = i % matrix_offset_;
+      values[!reversed] = i / matrix_offset_;
+      matrix_[i] = constraint.Supports(values);
+    }
+  }
+  relation_id_ = -1;
 }
 
 void Constraint::InitMatrix(const Network& network) {
@@ -28,22 +96,83 @@ void Constraint::InitMatrix(const Network& network) {
   const int domain_size2 = var2.num_values();
   matrix_offset_ = domain_size1;
 
-  vector<vector<int> > domains;
-  domains.push_back(var1.domain());
-  domains.push_back(var2.domain());
-  auto const key = make_pair(domains, relation_id_);
-  DomainsRelationHash hasher;
-  assert(hasher(key) == hasher(make_pair(domains, relation_id_)));
+  // Variables are keyed by their reference domain, unless their values
+  // deviate from it.
+  const Variable* vars[2] = {&var1, &var2};
+  MatrixKey key;
+  key.network_id = network.id();
+  key.relation_id = relation_id_;
+  for (int i = 0; i < 2; ++i) {
+    const Variable& var = *vars[i];
+    const Domain& domain = network.domain(var.domain_id());
+    const int num_values = var.num_values();
+    bool reference = domain.size() == num_values;
+    for (int v = 0; reference && v < num_values; ++v) {
+      reference = domain.at(v) == var.value(v);
+    }
+    key.domain_ids[i] = reference ? var.domain_id() : -1;
+    if (!reference) {
+      key.values[i].reserve(num_values);
+      for (int v = 0; v < num_values; ++v) {
+        key.values[i].push_back(var.value(v));
+      }
+    }
+  }
   auto cached_matrix = matrix_cache_.find(key);
   if (cached_matrix == matrix_cache_.end()) {
     // Matrix is not cached, create it.
-    matrix_.resize(domain_size1 * domain_size2);
-    vector<int> values(2);
-    for (int v1 = 0; v1 < domain_size1; ++v1) {
-      values[0] = var1.value(v1);
+    const Relation::TupleSet& tuples = relation.tuples();
+    const bool supporting = relation.semantics() == Relation::kSupports;
+    if (tuples.size() < static_cast<size_t>(domain_size1 * domain_size2)) {
+      // Set only the listed tuples, all other pairs get the default.
+      matrix_.assign(domain_size1 * domain_size2, !supporting);
+      unordered_map<int, int> value_ids1;
+      unordered_map<int, int> value_ids2;
+      for (int v1 = 0; v1 < domain_size1; ++v1) {
+        value_ids1[var1.value(v1)] = v1;
+      }
       for (int v2 = 0; v2 < domain_size2; ++v2) {
-        values[1] = var2.value(v2);
-        matrix_[v1 + matrix_offset_ * v2] = relation.Supports(values);
+        value_ids2[var2.value(v2)] = v2;
+      }
+      assert(tuples.empty() || tuples.arity() == 2);
+      for (size_t i = 0, size = tuples.size(); i < size; ++i) {
+        const int* tuple = tuples.tuple(i);
+        // A wildcard expands to all values of its variable.
+        int beg1 = 0;
+        int end1 = domain_size1;
+        if (tuple[0] != TupleTable::kAny) {
+          auto v1 = value_ids1.find(tuple[0]);
+          if (v1 == value_ids1.end()) {
+            continue;
+          }
+          beg1 = v1->second;
+          end1 = beg1 + 1;
+        }
+        int beg2 = 0;
+        int end2 = domain_size2;
+        if (tuple[1] != TupleTable::kAny) {
+          auto v2 = value_ids2.find(tuple[1]);
+          if (v2 == value_ids2.end()) {
+            continue;
+          }
+          beg2 = v2->second;
+          end2 = beg2 + 1;
+        }
+        for (int v2 = beg2; v2 < end2; ++v2) {
+          for (int v1 = beg1; v1 < end1; ++v1) {
+            matrix_[v1 + matrix_offset_ * v2] = supporting;
+          }
+        }
+      }
+    } else {
+      matrix_.resize(domain_size1 * domain_size2);
+      vector<int> values(2);
+      for (int v1 = 0; v1 < domain_size1; ++v1) {
+        values[0] = var1.value(v1);
+        for (int v2 = 0; v2 < domain_size2; ++v2) {
+          values[1] = var2.value(v2);
+          matrix_[v1 + matrix_offset_ * v2] = relation.Supports(values);
+        }
       }
     }
     matrix_cache_[key] = matrix_;
@@ -52,7 +181,88 @@ void Constraint::InitMatrix(const Network& network) {
   }
 }
 
+void Constraint::InitTable(const Network& network) {
+  const Relation& relation = network.relation(relation_id_);
+  const bool conflicting = relation.semantics() == Relation::kConflicts;
+  const int arity = scope_.size();
+  vector<const Variable*> vars(arity);
+  vector<int> domain_sizes(arity);
+  vector<unordered_map<int, int> > ids(arity);
+  for (int i = 0; i < arity; ++i) {
+    vars[i] = &network.variable(scope_[i]);
+    domain_sizes[i] = vars[i]->num_values();
+    for (int v = 0; v < domain_sizes[i]; ++v) {
+      ids[i][vars[i]->value(v)] = v;
+    }
+  }
+  // Translate the tuples within the domains to value ids. The wildcards of
+  // supporting tuples are kept, those of conflicting tuples are expanded,
+  // since their propagation counts the conflicting tuples of each value.
+  const Relation::TupleSet& relation_tuples = relation.tuples();
+  assert(relation_tuples.empty() || relation_tuples.arity() == arity);
+  TupleTable tuples(arity);
+  tuples.Reserve(relation_tuples.size());
+  vector<int> value_ids(arity, 0);
+  vector<int> wildcards;
+  for (size_t t = 0, size = relation_tuples.size(); t < size; ++t) {
+    const int* tuple = relation_tuples.tuple(t);
+    wildcards.clear();
+    int i = 0;
+    for (; i < arity; ++i) {
+      if (tuple[i] == TupleTable::kAny) {
+        value_ids[i] = TupleTable::kAny;
+        if (conflicting) {
+          wildcards.push_back(i);
+        }
+        continue;
+      }
+      auto id = ids[i].find(tuple[i]);
+      if (id == ids[i].end()) {
+        break;
+      }
+      value_ids[i] = id->second;
+    }
+    if (i < arity) {
+      continue;
+    }
+    if (wildcards.empty()) {
+      tuples.Insert(value_ids);
+      continue;
+    }
+    size_t num_expanded = 1;
+    for (auto it = wildcards.cbegin(), end = wildcards.cend();
+         it != end && num_expanded <= CompactTable::kMaxNumTuples; ++it) {
+      num_expanded *= domain_sizes[*it];
+      value_ids[*it] = 0;
+    }
+    if (num_expanded == 0) {
+      continue;
+    }
+    if (tuples.size() + num_expanded > CompactTable::kMaxNumTuples) {
+      cout << "Constraint " << name_ << " has more than "
+           << CompactTable::kMaxNumTuples
+           << " conflicting tuples after wildcard expansion.\n";
+      exit(1);
+    }
+    bool done = false;
+    while (!done) {
+      tuples.Insert(value_ids);
+      auto it = wildcards.crbegin();
+      while (it != wildcards.crend() &&
+             ++value_ids[*it] == domain_sizes[*it]) {
+        value_ids[*it] = 0;
+        ++it;
+      }
+      done = it == wildcards.crend();
+    }
+  }
+  table_ = new CompactTable(domain_sizes, tuples, conflicting);
+}
+
 bool Constraint::Supports(const vector<int>& values) const {
+  if (table_) {
+    return table_->Supports(values);
+  }
   assert(values.size() == 2);
   assert(values[0] >= 0 && values[1] >= 0);
   assert(values[0] + matrix_offset_ * values[1] <
@@ -64,10 +274,39 @@ bool Constraint::Conflicts(const vector<int>& values) const {
   return !Supports(values);
 }
 
+bool Constraint::Propagate(Network* network, vector<int>* reduced) {
+  assert(table_);
+  return table_->Propagate(scope_, network, reduced);
+}
+
+void Constraint::StartTransaction() {
+  assert(table_);
+  table_->StartTransaction();
+}
+
+void Constraint::CommitTransaction() {
+  assert(table_);
+  table_->CommitTransaction();
+}
+
+void Constraint::RollbackTransaction() {
+  assert(table_);
+  table_->RollbackTransaction();
+}
+
+int Constraint::num_prunings() const {
+  assert(table_);
+  return table_->num_prunings();
+}
+
 const string& Constraint::name() const {
   return name_;
 }
 
+int Constraint::relation_id() const {
+  return relation_id_;
+}
+
 int Constraint::arity() const {
   return scope_.size();
 }
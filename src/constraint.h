@@ -5,61 +5,93 @@
 #include <unordered_map>
 #include <string>
 #include <vector>
-#include <utility>
 
 namespace ace {
 
 class Network;
-
-struct DomainsRelationHash {
-  size_t operator()(const std::pair<std::vector<std::vector<int> >, int>& pair)
-                    const {
-    size_t h = 0x5391;
-    for (auto it = pair.first.cbegin(), end = pair.first.cend();
-         it != end; ++it) {
-      const std::vector<int>& domain = *it;
-      for (auto it2 = domain.cbegin(), end2 = domain.cend();
-           it2 != end2; ++it2) {
-        h ^= (h * *it2 << 7) ^ (h * *it2);
-      }
-    }
-    return h ^ pair.second;
+class CompactTable;
+
+// Identifies a cached constraint matrix by the network, the relation and the
+// reference domains of the scope variables. Variables whose values deviate
+// from their reference domain are identified by their values instead, with
+// domain id -1.
+struct MatrixKey {
+  bool operator==(const MatrixKey& rhs) const {
+    return network_id == rhs.network_id && relation_id == rhs.relation_id &&
+           domain_ids[0] == rhs.domain_ids[0] &&
+           domain_ids[1] == rhs.domain_ids[1] &&
+           values[0] == rhs.values[0] && values[1] == rhs.values[1];
   }
+
+  int network_id;
+  int relation_id;
+  int domain_ids[2];
+  std::vector<int> values[2];
 };
 
-struct DomainsRelationEqual {
-  bool operator()(const std::pair<std::vector<std::vector<int> >, int>& lhs,
-                  const std::pair<std::vector<std::vector<int> >, int>& rhs)
-                  const {
-    if (lhs.second != rhs.second ||
-        lhs.first.size() != rhs.first.size()) {
-      return false;
-    }
-    const int size = lhs.first.size();
-    for (int i = 0; i < size; ++i) {
-      const std::vector<int>& lhs_domain = lhs.first[i];
-      const std::vector<int>& rhs_domain = rhs.first[i];
-      if (lhs_domain != rhs_domain) {
-        return false;
+struct MatrixKeyHash {
+  size_t operator()(const MatrixKey& key) const {
+    size_t h = 0x5391;
+    h = h * 31 + key.network_id;
+    h = h * 31 + key.relation_id;
+    for (int i = 0; i < 2; ++i) {
+      h = h * 31 + key.domain_ids[i];
+      const std::vector<int>& values = key.values[i];
+      for (auto it = values.cbegin(), end = values.cend(); it != end; ++it) {
+        h ^= (h * *it << 7) ^ (h * *it);
       }
     }
-    return true;
+    return h;
   }
 };
 
-// A constraint for a constraint network.
+// A constraint for a constraint network. Binary constraints keep a matrix of
+// the supported value pairs, constraints of other arities a compact table.
 class Constraint {
  public:
   // Initialises the constraint given its name, its relation and its scope.
   Constraint(const std::string& name, const int relation_id,
              const std::vector<int>& scope, const Network& network);
 
+  Constraint(const Constraint& constraint);
+  Constraint& operator=(const Constraint& constraint);
+
+  // Deletes the table of a non-binary constraint.
+  ~Constraint();
+
+  // Initialises a copy of the constraint on given scope, which renames the
+  // variables of the original scope in the same order.
+  Constraint(const Constraint& constraint, const std::vector<int>& scope);
+
+  // Restricts the supported value pairs to those also supported by the given
+  // constraint on the same variables, in either order. The constraint is not
+  // described by a single relation afterwards.
+  void Conjoin(const Constraint& constraint);
+
   bool Supports(const std::vector<int>& values) const;
   bool Conflicts(const std::vector<int>& values) const;
 
+  // Enforces generalised arc-consistency for a non-binary constraint on the
+  // domains of the network. Adds the ids of the reduced variables.
+  // Returns false if the constraint cannot be satisfied anymore.
+  bool Propagate(Network* network, std::vector<int>* reduced);
+
+  // Starts, commits or rolls back a transaction on the propagation state of a
+  // non-binary constraint, in line with the network domains.
+  void StartTransaction();
+  void CommitTransaction();
+  void RollbackTransaction();
+
+  // Returns the number of values removed by the propagation of a non-binary
+  // constraint.
+  int num_prunings() const;
+
   // Returns the name of the constraint.
   const std::string& name() const;
 
+  // Returns the id of the constraint relation, -1 for conjoined constraints.
+  int relation_id() const;
+
   // Returns the scope size of the constraint.
   int arity() const;
 
@@ -71,17 +103,18 @@ class Constraint {
 
  private:
   void InitMatrix(const Network& network);
+  void InitTable(const Network& network);
 
-  typedef std::unordered_map<std::pair<std::vector<std::vector<int> >, int>,
-                             std::vector<bool>,
-                             DomainsRelationHash,
-                             DomainsRelationEqual> MatrixCache;
+  typedef std::unordered_map<MatrixKey, std::vector<bool>,
+                             MatrixKeyHash> MatrixCache;
 
   static MatrixCache matrix_cache_;
 
   std::vector<int> scope_;
   std::vector<bool> matrix_;
   int matrix_offset_;
+  // The supported tuples of a non-binary constraint.
+  CompactTable* table_;
   int relation_id_;
   std::string name_;
 };
@@ -0,0 +1,276 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include "./cycle-cutset-solver.h"
+#include <cassert>
+#include <set>
+#include <vector>
+#include <algorithm>
+#include "./clock.h"
+#include "./network.h"
+#include "./variable-ordering.h"
+#include "./max-cardinality-ordering.h"
+
+using std::vector;
+using std::set;
+using std::min;
+using base::Clock;
+
+namespace ace {
+
+CycleCutsetSolver::CycleCutsetSolver(Network* network)
+    : Solver(),
+      network_(*network),
+      preprocessor_(network),
+      time_limit_(Solver::kDefTimeLimit),
+      max_num_solutions_(1) {
+  Reset();
+  SelectCutset(MaxCardinalityOrdering(network_).CreateOrdering());
+}
+
+void CycleCutsetSolver::SelectCutset(const vector<int>& ordering) {
+  const int num_vars = network_.num_variables();
+  const vector<set<int> > graph = VariableOrdering::PrimalGraph(network_);
+  cutset_.clear();
+  forest_.clear();
+  tree_parents_.assign(num_vars, -1);
+  vector<bool> in_forest(num_vars, false);
+  for (auto it = ordering.cbegin(), end = ordering.cend(); it != end; ++it) {
+    const int var_id = *it;
+    const set<int>& neighs = graph[var_id];
+    int num_parents = 0;
+    for (auto it2 = neighs.cbegin(), end2 = neighs.cend();
+         it2 != end2 && num_parents < 2; ++it2) {
+      if (in_forest[*it2]) {
+        tree_parents_[var_id] = *it2;
+        ++num_parents;
+      }
+    }
+    if (num_parents < 2) {
+      forest_.push_back(var_id);
+      in_forest[var_id] = true;
+    } else {
+      tree_parents_[var_id] = -1;
+      cutset_.push_back(var_id);
+    }
+  }
+  // Move the cutset variables back into the forest, which are connected to at
+  // most one forest variable by now.
+  vector<int> cutset;
+  for (auto it = cutset_.cbegin(), end = cutset_.cend(); it != end; ++it) {
+    const int var_id = *it;
+    const set<int>& neighs = graph[var_id];
+    int num_neighs = 0;
+    int parent = -1;
+    for (auto it2 = neighs.cbegin(), end2 = neighs.cend();
+         it2 != end2 && num_neighs < 2; ++it2) {
+      if (in_forest[*it2]) {
+        parent = *it2;
+        ++num_neighs;
+      }
+    }
+    if (num_neighs < 2) {
+      tree_parents_[var_id] = parent;
+      forest_.push_back(var_id);
+      in_forest[var_id] = true;
+    } else {
+      cutset.push_back(var_id);
+    }
+  }
+  cutset_.swap(cutset);
+}
+
+bool CycleCutsetSolver::Solve() {
+  Reset();
+  begin_clock_ = Clock(clock_type_);
+  solutions_.clear();
+  num_solutions_ = 0;
+  Assignment assignment(network_);
+  SolveCutset(0, &assignment);
+  duration_ = Clock(clock_type_) - begin_clock_;
+  return num_solutions_;
+}
+
+bool CycleCutsetSolver::SolveCutset(const int index, Assignment* assignment) {
+  if (index == static_cast<int>(cutset_.size())) {
+    return SolveForest(assignment);
+  } else if (cancelled_ || Clock(clock_type_) - begin_clock_ > time_limit_) {
+    // Time limit reached or search cancelled.
+    timeout_ = true;
+    return false;
+  }
+  const int var_id = cutset_[index];
+  Variable& var = network_.variable(var_id);
+  const vector<int> domain = var.valid_value_ids();
+  for (auto it = domain.rbegin(), end = domain.rend(); it != end; ++it) {
+    const int value = *it;
+    ++num_explored_states_;
+    assignment->Assign(var_id, value);
+    // Start a transaction to track all domain changes.
+    network_.StartTransaction();
+    // Reduce the domain of the selected variable for the consistency test,
+    // which also removes the forest values conflicting with the assignment.
+    var.ReduceDomain(value);
+    if (preprocessor_.Propagate(var_id) &&
+        SolveCutset(index + 1, assignment)) {
+      // Commit the transaction, stops tracking changes.
+      network_.CommitTransaction();
+      return true;
+    }
+    // Rollback all tracked domain changes.
+    network_.RollbackTransaction();
+    assignment->Revert();
+    if (timeout_) {
+      break;
+    }
+    ++num_backtracks_;
+  }
+  return false;
+}
+
+bool CycleCutsetSolver::SolveForest(Assignment* assignment) {
+  ++num_forest_solves_;
+  network_.StartTransaction();
+  const bool consistent = EnforceDac();
+  if (consistent) {
+    // Each parent value has a support in the domains of its children, the
+    // forest is solved without backtracking along the tree ordering.
+    for (auto it = forest_.cbegin(), end = forest_.cend(); it != end; ++it) {
+      const int var_id = *it;
+      const int parent = tree_parents_[var_id];
+      const vector<int> domain = network_.variable(var_id).valid_value_ids();
+      auto value = domain.crbegin();
+      while (parent != -1 && value != domain.crend() &&
+             !Supports(var_id, *value, parent, assignment->value(parent))) {
+        ++value;
+      }
+      assert(value != domain.crend());
+      ++num_explored_states_;
+      assignment->Assign(var_id, *value);
+    }
+    assert(assignment->Complete() && assignment->Consistent());
+    AddSolution(*assignment, &solutions_);
+    for (int i = forest_.size(); i > 0; --i) {
+      assignment->Revert();
+    }
+  }
+  network_.RollbackTransaction();
+  return consistent;
+}
+
+bool CycleCutsetSolver::EnforceDac() {
+  // Revise each parent with respect to its child, from the leaves to the
+  // roots. The values conflicting with the cutset assignment have already
+  // been removed by propagation.
+  for (auto it = forest_.crbegin(), end = forest_.crend(); it != end; ++it) {
+    const int var_id = *it;
+    const int parent = tree_parents_[var_id];
+    if (parent == -1) {
+      continue;
+    }
+    const vector<int> domain = network_.variable(var_id).valid_value_ids();
+    if (domain.empty()) {
+      return false;
+    }
+    Variable& parent_var = network_.variable(parent);
+    const vector<int> parent_domain = parent_var.valid_value_ids();
+    for (auto it2 = parent_domain.cbegin(), end2 = parent_domain.cend();
+         it2 != end2; ++it2) {
+      bool supported = false;
+      for (auto it3 = domain.cbegin(), end3 = domain.cend();
+           it3 != end3 && !supported; ++it3) {
+        supported = Supports(var_id, *it3, parent, *it2);
+      }
+      if (!supported) {
+        parent_var.RemoveValue(*it2);
+      }
+    }
+  }
+  // The roots may have been wiped out.
+  for (auto it = forest_.cbegin(), end = forest_.cend(); it != end; ++it) {
+    if (tree_parents_[*it] == -1 &&
+        network_.variable(*it).valid_value_ids().empty()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool CycleCutsetSolver::Supports(const int var_id, const int value,
+                                 const int other_id,
+                                 const int other_value) const {
+  const vector<int>& cons = network_.constraints(var_id);
+  vector<int> values(2, 0);
+  for (auto it = cons.cbegin(), end = cons.cend(); it != end; ++it) {
+    const Constraint& constraint = network_.constraint(*it);
+    assert(constraint.arity() == 2);
+    if (constraint.scope(0) == var_id && constraint.scope(1) == other_id) {
+      values[0] = value;
+      values[1] = other_value;
+    } else if (constraint.scope(0) == other_id &&
+               constraint.scope(1) == var_id) {
+      values[0] = other_value;
+      values[1] = value;
+    } else {
+      continue;
+    }
+    if (!constraint.Supports(values)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void CycleCutsetSolver::Reset() {
+  duration_ = 0;
+  num_backtracks_ = 0;
+  num_explored_states_ = 0.0;
+  num_forest_solves_ = 0;
+  timeout_ = false;
+}
+
+void CycleCutsetSolver::variable_ordering(
+    const VariableOrdering& var_ordering) {
+  SelectCutset(var_ordering.CreateOrdering());
+}
+
+void CycleCutsetSolver::time_limit(const Clock::Diff& limit) {
+  time_limit_ = min(limit, Solver::kDefTimeLimit);
+}
+
+Clock::Diff CycleCutsetSolver::time_limit() const {
+  return time_limit_;
+}
+
+void CycleCutsetSolver::max_num_solutions(const int num) {
+  // The forest is only solved backtrack-free for the first solution.
+  max_num_solutions_ = 1;
+}
+
+int CycleCutsetSolver::max_num_solutions() const {
+  return max_num_solutions_;
+}
+
+const vector<Assignment>& CycleCutsetSolver::solutions() const {
+  return solutions_;
+}
+
+double CycleCutsetSolver::num_explored_states() const {
+  return num_explored_states_;
+}
+
+int CycleCutsetSolver::num_backtracks() const {
+  return num_backtracks_;
+}
+
+int CycleCutsetSolver::cutset_size() const {
+  return cutset_.size();
+}
+
+int CycleCutsetSolver::num_forest_solves() const {
+  return num_forest_solves_;
+}
+
+Clock::Diff CycleCutsetSolver::duration() const {
+  return duration_;
+}
+
+}  // namespace ace
@@ -0,0 +1,114 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#ifndef SRC_CYCLE_CUTSET_SOLVER_H_
+#define SRC_CYCLE_CUTSET_SOLVER_H_
+
+#include <vector>
+#include "./solver.h"
+#include "./clock.h"
+#include "./assignment.h"
+#include "./ac3.h"
+
+namespace ace {
+
+// The constraint network.
+class Network;
+
+// The variable ordering.
+class VariableOrdering;
+
+// A constraint network solver based on the cycle-cutset method. Along the
+// variable ordering (max-cardinality by default), each variable with more than
+// one earlier neighbour outside of the cutset joins the cutset, the remaining
+// variables form a forest. The cutset assignments are enumerated by
+// backtracking with arc-consistency look-ahead, for each the forest is made
+// directional arc-consistent and solved without backtracking.
+// Searches for a single solution.
+class CycleCutsetSolver : public Solver {
+ public:
+  // Initialises the solver with the given network.
+  explicit CycleCutsetSolver(Network* network);
+
+  // Searches for a solution for the network.
+  // Returns whether it found a solution.
+  bool Solve();
+
+  // Resets the solver meta-information, which is collected during search.
+  void Reset();
+
+  // Sets the variable ordering, which determines the cutset.
+  void variable_ordering(const VariableOrdering& var_ordering);
+
+  // Sets the time limit for the search. Search will be terminated if the time
+  // limit is exceeded, returning false.
+  void time_limit(const base::Clock::Diff& limit);
+
+  // Returns the set time limit.
+  base::Clock::Diff time_limit() const;
+
+  // Sets the maximum number of solutions to be searched for, only a single
+  // solution is searched for.
+  void max_num_solutions(const int num);
+
+  // Returns the set maximum number of solutions to be searched for.
+  int max_num_solutions() const;
+
+  // Returns a const reference to the solutions found by the last search.
+  const std::vector<Assignment>& solutions() const;
+
+  // Returns the duration of the last search in microseconds.
+  base::Clock::Diff duration() const;
+
+  // Returns the number of backtracks used during the last search.
+  int num_backtracks() const;
+
+  // Returns the number of states explored during the last search.
+  double num_explored_states() const;
+
+  // Returns the number of variables in the cutset.
+  int cutset_size() const;
+
+  // Returns the number of cutset assignments for which the forest has been
+  // solved during the last search.
+  int num_forest_solves() const;
+
+ private:
+  // Splits the variables into the cutset and the forest along given ordering.
+  void SelectCutset(const std::vector<int>& ordering);
+
+  // Assigns the cutset variables from given index on, then solves the forest.
+  // Returns whether a solution was found.
+  bool SolveCutset(const int index, Assignment* assignment);
+
+  // Solves the forest given the complete cutset assignment.
+  // Returns whether a solution was found.
+  bool SolveForest(Assignment* assignment);
+
+  // Enforces directional arc-consistency along the tree ordering.
+  // Returns false if a domain is wiped out.
+  bool EnforceDac();
+
+  // Returns whether the value pair is supported by all constraints between
+  // the two variables.
+  bool Supports(const int var_id, const int value, const int other_id,
+                const int other_value) const;
+
+  Network& network_;
+  Ac3 preprocessor_;
+  std::vector<int> cutset_;
+  // The forest variables in tree ordering, each preceded by its parent.
+  std::vector<int> forest_;
+  // The parent of each forest variable, -1 for roots and cutset variables.
+  std::vector<int> tree_parents_;
+  std::vector<Assignment> solutions_;
+  double num_explored_states_;
+  int num_backtracks_;
+  int num_forest_solves_;
+  bool timeout_;
+  base::Clock begin_clock_;
+  base::Clock::Diff duration_;
+  base::Clock::Diff time_limit_;
+  size_t max_num_solutions_;
+};
+
+}  // namespace ace
+#endif  // SRC_CYCLE_CUTSET_SOLVER_H_
@@ -0,0 +1,303 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include "./eps-solver.h"
+#include <cassert>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include "./clock.h"
+#include "./network.h"
+#include "./variable-ordering.h"
+
+using std::vector;
+using std::thread;
+using std::mutex;
+using std::lock_guard;
+using std::min;
+using std::max;
+using base::Clock;
+
+namespace ace {
+
+const int EpsSolver::kDefSubproblemsPerWorker = 30;
+
+EpsSolver::Worker::Worker(const Network& root)
+    : network(root),
+      preprocessor(&network),
+      solver(&network),
+      num_explored_states(0.0),
+      num_backtracks(0) {}
+
+EpsSolver::EpsSolver(const Network& network, const int num_workers)
+    : Solver(),
+      network_(network),
+      preprocessor_(&network_),
+      next_subproblem_(0),
+      done_(false),
+      depth_(0),
+      max_depth_(0),
+      begin_clock_(Clock::kWallTime),
+      time_limit_(Solver::kDefTimeLimit),
+      max_num_solutions_(Solver::kDefMaxNumSolutions) {
+  assert(num_workers > 0);
+  for (int w = 0; w < num_workers; ++w) {
+    workers_.push_back(new Worker(network_));
+  }
+  Reset();
+  // Set the lexicographical variable ordering.
+  const int num_vars = network_.num_variables();
+  var_ordering_.resize(num_vars, 0);
+  for (int i = 0; i < num_vars; ++i) {
+    var_ordering_[i] = i;
+  }
+}
+
+EpsSolver::~EpsSolver() {
+  for (auto it = workers_.begin(), end = workers_.end(); it != end; ++it) {
+    delete *it;
+  }
+}
+
+bool EpsSolver::Solve() {
+  Reset();
+  begin_clock_ = Clock(Clock::kWallTime);
+  solutions_.clear();
+  num_solutions_ = 0;
+  done_ = false;
+  next_subproblem_ = 0;
+  Decompose();
+
+  const int num_workers = workers_.size();
+  num_running_ = num_workers;
+  vector<thread> threads;
+  threads.reserve(num_workers);
+  for (int w = 0; w < num_workers; ++w) {
+    threads.push_back(thread(&EpsSolver::Run, this, w));
+  }
+  {
+    // The time limit is enforced in wall time here.
+    std::unique_lock<mutex> lock(running_mutex_);
+    auto all_finished = [this] { return num_running_ == 0; };
+    // The decomposition counts towards the time limit.
+    const Clock::Diff remaining =
+      max(time_limit_ - (Clock(Clock::kWallTime) - begin_clock_),
+          Clock::Diff(0));
+    if (time_limit_ >= Solver::kMaxWaitTime) {
+      finished_.wait(lock, all_finished);
+    } else if (!finished_.wait_for(lock, std::chrono::microseconds(remaining),
+                                   all_finished)) {
+      lock.unlock();
+      Stop();
+    }
+  }
+  for (auto it = threads.begin(), end = threads.end(); it != end; ++it) {
+    it->join();
+  }
+  duration_ = Clock(Clock::kWallTime) - begin_clock_;
+  return num_solutions_;
+}
+
+void EpsSolver::Decompose() {
+  const int num_vars = network_.num_variables();
+  const size_t target = kDefSubproblemsPerWorker * workers_.size();
+  subproblems_.assign(1, Subproblem());
+  depth_ = 0;
+  while (subproblems_.size() && depth_ < num_vars &&
+         (max_depth_ ? depth_ < max_depth_ : subproblems_.size() < target)) {
+    // Extend all subproblems by the next variable, keeping only the
+    // arc-consistent ones in the order of the sequential search.
+    const int var_id = var_ordering_[depth_];
+    vector<Subproblem> extended;
+    for (auto it = subproblems_.cbegin(), end = subproblems_.cend();
+         it != end; ++it) {
+      const Subproblem& subproblem = *it;
+      network_.StartTransaction();
+      if (Apply(subproblem, &network_, &preprocessor_)) {
+        Variable& var = network_.variable(var_id);
+        const vector<int> domain = var.valid_value_ids();
+        for (auto it2 = domain.rbegin(), end2 = domain.rend();
+             it2 != end2; ++it2) {
+          const int value = *it2;
+          ++num_explored_states_;
+          network_.StartTransaction();
+          var.ReduceDomain(value);
+          if (preprocessor_.Propagate(var_id)) {
+            extended.push_back(subproblem);
+            extended.back().push_back(value);
+          }
+          network_.RollbackTransaction();
+        }
+      }
+      network_.RollbackTransaction();
+    }
+    subproblems_.swap(extended);
+    ++depth_;
+  }
+}
+
+void EpsSolver::Run(const int worker_id) {
+  Worker* worker = workers_[worker_id];
+  const int num_subproblems = subproblems_.size();
+  while (!done_) {
+    const int s = next_subproblem_++;
+    if (s >= num_subproblems) {
+      // All subproblems are taken.
+      break;
+    }
+    const Clock::Diff elapsed = Clock(Clock::kWallTime) - begin_clock_;
+    if (cancelled_ || elapsed > time_limit_) {
+      // Time limit reached or search cancelled.
+      done_ = true;
+      break;
+    }
+    worker->network.StartTransaction();
+    if (Apply(subproblems_[s], &worker->network, &worker->preprocessor)) {
+      BacktrackSolver& solver = worker->solver;
+      {
+        lock_guard<mutex> lock(solutions_mutex_);
+        // Unlimited solutions are kept unlimited for the subproblems.
+        solver.max_num_solutions(
+          max_num_solutions_ >= static_cast<size_t>(kDefMaxNumSolutions) ? 0 :
+          max_num_solutions_ - num_solutions_);
+      }
+      solver.Solve();
+      worker->num_explored_states += solver.num_explored_states();
+      worker->num_backtracks += solver.num_backtracks();
+      AddSolutions(solver);
+    }
+    worker->network.RollbackTransaction();
+  }
+  lock_guard<mutex> lock(running_mutex_);
+  --num_running_;
+  finished_.notify_one();
+}
+
+bool EpsSolver::Apply(const Subproblem& subproblem, Network* network,
+                      Ac3* preprocessor) const {
+  const int depth = subproblem.size();
+  for (int i = 0; i < depth; ++i) {
+    const int var_id = var_ordering_[i];
+    network->variable(var_id).ReduceDomain(subproblem[i]);
+    if (!preprocessor->Propagate(var_id)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void EpsSolver::AddSolutions(const BacktrackSolver& solver) {
+  if (!solver.num_solutions()) {
+    return;
+  }
+  lock_guard<mutex> lock(solutions_mutex_);
+  if (sink_) {
+    // The solutions are already streamed by the worker solver.
+    num_solutions_ += solver.num_solutions();
+  } else {
+    const vector<Assignment>& solutions = solver.solutions();
+    for (auto it = solutions.cbegin(), end = solutions.cend();
+         it != end && num_solutions_ < max_num_solutions_; ++it) {
+      Solver::AddSolution(*it, &solutions_);
+    }
+  }
+  if (num_solutions_ >= max_num_solutions_) {
+    // Enough solutions found.
+    Stop();
+  }
+}
+
+void EpsSolver::Stop() {
+  done_ = true;
+  for (auto it = workers_.begin(), end = workers_.end(); it != end; ++it) {
+    (*it)->solver.Cancel();
+  }
+}
+
+void EpsSolver::Cancel() {
+  Solver::Cancel();
+  for (auto it = workers_.begin(), end = workers_.end(); it != end; ++it) {
+    (*it)->solver.Cancel();
+  }
+}
+
+void EpsSolver::solution_sink(SolutionSink* sink) {
+  Solver::solution_sink(sink);
+  for (auto it = workers_.begin(), end = workers_.end(); it != end; ++it) {
+    (*it)->solver.solution_sink(sink);
+  }
+}
+
+void EpsSolver::Reset() {
+  duration_ = 0;
+  num_explored_states_ = 0.0;
+  for (auto it = workers_.begin(), end = workers_.end(); it != end; ++it) {
+    Worker* worker = *it;
+    worker->num_explored_states = 0.0;
+    worker->num_backtracks = 0;
+  }
+}
+
+void EpsSolver::variable_ordering(const VariableOrdering& var_ordering) {
+  var_ordering_ = var_ordering.CreateOrdering();
+  for (auto it = workers_.begin(), end = workers_.end(); it != end; ++it) {
+    (*it)->solver.variable_ordering(var_ordering);
+  }
+}
+
+void EpsSolver::decomposition_depth(const int depth) {
+  max_depth_ = depth > 0 ? depth : 0;
+}
+
+int EpsSolver::decomposition_depth() const {
+  return depth_;
+}
+
+void EpsSolver::time_limit(const Clock::Diff& limit) {
+  time_limit_ = min(limit, Solver::kDefTimeLimit);
+}
+
+Clock::Diff EpsSolver::time_limit() const {
+  return time_limit_;
+}
+
+void EpsSolver::max_num_solutions(const int num) {
+  max_num_solutions_ = num > 0 ? num : Solver::kDefMaxNumSolutions;
+}
+
+int EpsSolver::max_num_solutions() const {
+  return max_num_solutions_;
+}
+
+const vector<Assignment>& EpsSolver::solutions() const {
+  return solutions_;
+}
+
+double EpsSolver::num_explored_states() const {
+  double num_explored_states = num_explored_states_;
+  for (auto it = workers_.cbegin(), end = workers_.cend(); it != end; ++it) {
+    num_explored_states += (*it)->num_explored_states;
+  }
+  return num_explored_states;
+}
+
+int EpsSolver::num_backtracks() const {
+  int num_backtracks = 0;
+  for (auto it = workers_.cbegin(), end = workers_.cend(); it != end; ++it) {
+    num_backtracks += (*it)->num_backtracks;
+  }
+  return num_backtracks;
+}
+
+int EpsSolver::num_subproblems() const {
+  return subproblems_.size();
+}
+
+int EpsSolver::num_workers() const {
+  return workers_.size();
+}
+
+Clock::Diff EpsSolver::duration() const {
+  return duration_;
+}
+
+}  // namespace ace
@@ -0,0 +1,147 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#ifndef SRC_EPS_SOLVER_H_
+#define SRC_EPS_SOLVER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+#include "./solver.h"
+#include "./clock.h"
+#include "./assignment.h"
+#include "./network.h"
+#include "./ac3.h"
+#include "./backtrack-solver.h"
+
+namespace ace {
+
+// The variable ordering.
+class VariableOrdering;
+
+// A constraint network solver based on embarrassingly parallel search (EPS).
+// The network is statically decomposed into many independent subproblems,
+// which are the arc-consistent partial assignments over the first variables of
+// the ordering. A pool of workers solves the subproblems, each worker with its
+// own network copy and backtrack solver.
+class EpsSolver : public Solver {
+ public:
+  static const int kDefSubproblemsPerWorker;
+
+  // Initialises the solver with the given network and number of workers.
+  EpsSolver(const Network& network, const int num_workers);
+
+  // Deletes the workers.
+  ~EpsSolver();
+
+  // Searches for a solution for the network.
+  // Returns whether it found a solution.
+  bool Solve();
+
+  // Cancels the search, including the running subproblem searches.
+  void Cancel();
+
+  // Resets the solver meta-information, which is collected during search.
+  void Reset();
+
+  // Sets the variable ordering.
+  void variable_ordering(const VariableOrdering& var_ordering);
+
+  // Sets the number of decomposed variables (0 for automatic selection based
+  // on the number of subproblems per worker).
+  void decomposition_depth(const int depth);
+
+  // Returns the decomposition depth used during the last search.
+  int decomposition_depth() const;
+
+  // Sets the time limit for the search, measured in wall time. Search will be
+  // terminated if the time limit is exceeded, returning false.
+  void time_limit(const base::Clock::Diff& limit);
+
+  // Returns the set time limit.
+  base::Clock::Diff time_limit() const;
+
+  // Sets the maximum number of solutions to be searched for.
+  void max_num_solutions(const int num);
+
+  // Returns the set maximum number of solutions to be searched for.
+  int max_num_solutions() const;
+
+  // Returns a const reference to the solutions found by the last search.
+  const std::vector<Assignment>& solutions() const;
+
+  // Sets the solution sink, which is shared by the workers. With a maximum
+  // number of solutions, concurrently solved subproblems may pass a few more
+  // solutions to the sink.
+  void solution_sink(SolutionSink* sink);
+
+  // Returns the wall time duration of the last search in microseconds.
+  base::Clock::Diff duration() const;
+
+  // Returns the number of backtracks over all subproblems during the last
+  // search.
+  int num_backtracks() const;
+
+  // Returns the number of states explored during the last search.
+  double num_explored_states() const;
+
+  // Returns the number of subproblems of the last decomposition.
+  int num_subproblems() const;
+
+  // Returns the number of workers.
+  int num_workers() const;
+
+ private:
+  // A subproblem, given by the values (by id) of the decomposed variables.
+  typedef std::vector<int> Subproblem;
+
+  // A subproblem solving worker with private network state.
+  struct Worker {
+    explicit Worker(const Network& network);
+
+    Network network;
+    Ac3 preprocessor;
+    BacktrackSolver solver;
+    double num_explored_states;
+    int num_backtracks;
+  };
+
+  // Decomposes the network into the subproblems.
+  void Decompose();
+
+  // Solves subproblems until the queue is empty, executed on separate threads.
+  void Run(const int worker_id);
+
+  // Applies the decisions of the subproblem to the network.
+  // Returns whether the network is still consistent.
+  bool Apply(const Subproblem& subproblem, Network* network,
+             Ac3* preprocessor) const;
+
+  // Records the solutions found by a worker solver.
+  void AddSolutions(const BacktrackSolver& solver);
+
+  // Stops the running subproblem searches, no further subproblems are taken.
+  void Stop();
+
+  Network network_;
+  Ac3 preprocessor_;
+  std::vector<Worker*> workers_;
+  std::vector<int> var_ordering_;
+  std::vector<Subproblem> subproblems_;
+  std::vector<Assignment> solutions_;
+  std::mutex solutions_mutex_;
+  std::mutex running_mutex_;
+  std::condition_variable finished_;
+  int num_running_;
+  std::atomic<int> next_subproblem_;
+  std::atomic<bool> done_;
+  int depth_;
+  int max_depth_;
+  double num_explored_states_;
+  base::Clock begin_clock_;
+  base::Clock::Diff duration_;
+  base::Clock::Diff time_limit_;
+  size_t max_num_solutions_;
+};
+
+}  // namespace ace
+#endif  // SRC_EPS_SOLVER_H_
@@ -0,0 +1,16 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include "./fixed-ordering.h"
+#include <vector>
+
+using std::vector;
+
+namespace ace {
+
+FixedOrdering::FixedOrdering(const vector<int>& ordering)
+    : ordering_(ordering) {}
+
+vector<int> FixedOrdering::CreateOrdering() const {
+  return ordering_;
+}
+
+}  // namespace ace
@@ -0,0 +1,20 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#ifndef SRC_FIXED_ORDERING_H_
+#define SRC_FIXED_ORDERING_H_
+
+#include <vector>
+#include "./variable-ordering.h"
+
+namespace ace {
+
+// A given variable ordering, created once by another ordering heuristic.
+class FixedOrdering : public VariableOrdering {
+ public:
+  explicit FixedOrdering(const std::vector<int>& ordering);
+  std::vector<int> CreateOrdering() const;
+ private:
+  std::vector<int> ordering_;
+};
+
+}  // namespace ace
+#endif  // SRC_FIXED_ORDERING_H_
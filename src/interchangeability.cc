@@ -0,0 +1,172 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include "./interchangeability.h"
+#include <cassert>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+#include "./network.h"
+#include "./assignment.h"
+#include "./solution-sink.h"
+
+using std::vector;
+using std::unordered_map;
+using std::hash;
+using base::Clock;
+
+namespace ace {
+
+Interchangeability::Interchangeability(Network* network)
+    : Preprocessor("NI"),
+      network_(network),
+      num_iterations_(0),
+      num_merged_(0),
+      duration_(0) {}
+
+bool Interchangeability::Preprocess() {
+  Clock beg;
+  num_iterations_ = 0;
+  num_merged_ = 0;
+  const int num_vars = network_->num_variables();
+  classes_.assign(num_vars, vector<vector<int> >());
+  merged_variables_.clear();
+  hash<vector<bool> > hasher;
+  for (int var_id = 0; var_id < num_vars; ++var_id) {
+    ++num_iterations_;
+    const vector<int>& constraints = network_->constraints(var_id);
+    bool binary = true;
+    for (auto it = constraints.cbegin(), end = constraints.cend();
+         it != end && binary; ++it) {
+      binary = network_->constraint(*it).arity() == 2;
+    }
+    if (!binary) {
+      // Support rows are only defined for binary constraints.
+      continue;
+    }
+    Variable& var = network_->variable(var_id);
+    const vector<int> domain = var.valid_value_ids();
+    // Bucket the values by the hash of their concatenated support rows.
+    vector<vector<bool> > rows(domain.size());
+    unordered_map<size_t, vector<int> > buckets;
+    for (int i = 0, size = domain.size(); i < size; ++i) {
+      SupportRow(var_id, domain[i], &rows[i]);
+      buckets[hasher(rows[i])].push_back(i);
+    }
+    if (buckets.size() == domain.size()) {
+      // All values are distinguishable.
+      continue;
+    }
+    classes_[var_id].resize(var.num_values());
+    for (int i = 0, size = domain.size(); i < size; ++i) {
+      vector<int>& bucket = buckets[hasher(rows[i])];
+      if (bucket.empty() || bucket.front() != i) {
+        // The value is already merged.
+        continue;
+      }
+      vector<int>& merged = classes_[var_id][domain[i]];
+      merged.push_back(domain[i]);
+      vector<int> remaining;
+      for (auto it = bucket.cbegin() + 1, end = bucket.cend();
+           it != end; ++it) {
+        if (rows[*it] == rows[i]) {
+          merged.push_back(domain[*it]);
+          var.RemoveValue(domain[*it]);
+          ++num_merged_;
+        } else {
+          // Hash collision.
+          remaining.push_back(*it);
+        }
+      }
+      bucket.swap(remaining);
+      if (merged.size() == 1) {
+        merged.clear();
+      }
+    }
+    merged_variables_.push_back(var_id);
+  }
+  duration_ = Clock() - beg;
+  return true;
+}
+
+void Interchangeability::SupportRow(const int var_id, const int value,
+                                    vector<bool>* row) const {
+  row->clear();
+  vector<int> values(2, 0);
+  const vector<int>& constraints = network_->constraints(var_id);
+  for (auto it = constraints.cbegin(), end = constraints.cend();
+       it != end; ++it) {
+    const Constraint& constraint = network_->constraint(*it);
+    assert(constraint.arity() == 2);
+    const int var_index = constraint.scope(0) == var_id ? 0 : 1;
+    const int var2_id = constraint.scope(1 - var_index);
+    values[var_index] = value;
+    if (var2_id == var_id) {
+      values[1 - var_index] = value;
+      row->push_back(constraint.Supports(values));
+      continue;
+    }
+    const vector<int> domain2 = network_->variable(var2_id).valid_value_ids();
+    for (auto it2 = domain2.cbegin(), end2 = domain2.cend();
+         it2 != end2; ++it2) {
+      values[1 - var_index] = *it2;
+      row->push_back(constraint.Supports(values));
+    }
+  }
+}
+
+void Interchangeability::Expand(const Assignment& solution,
+                                const int64_t max_num_solutions,
+                                SolutionSink* sink) const {
+  Assignment assignment(solution);
+  int64_t num_remaining = max_num_solutions;
+  ExpandRec(0, &assignment, &num_remaining, sink);
+}
+
+void Interchangeability::ExpandRec(const int var_index,
+                                   Assignment* assignment,
+                                   int64_t* num_remaining,
+                                   SolutionSink* sink) const {
+  if (*num_remaining <= 0) {
+    return;
+  }
+  if (var_index == static_cast<int>(merged_variables_.size())) {
+    sink->Add(*assignment);
+    --*num_remaining;
+    return;
+  }
+  const int var_id = merged_variables_[var_index];
+  const int value = assignment->value(var_id);
+  const vector<int>& merged = classes_[var_id][value];
+  if (merged.empty()) {
+    ExpandRec(var_index + 1, assignment, num_remaining, sink);
+    return;
+  }
+  for (auto it = merged.cbegin(), end = merged.cend(); it != end; ++it) {
+    assignment->Reassign(var_id, *it);
+    ExpandRec(var_index + 1, assignment, num_remaining, sink);
+  }
+  assignment->Reassign(var_id, value);
+}
+
+double Interchangeability::num_expansions(const Assignment& solution) const {
+  double num_expansions = 1.0;
+  for (auto it = merged_variables_.cbegin(), end = merged_variables_.cend();
+       it != end; ++it) {
+    const int num_merged = classes_[*it][solution.value(*it)].size();
+    num_expansions *= num_merged ? num_merged : 1;
+  }
+  return num_expansions;
+}
+
+Clock::Diff Interchangeability::duration() const {
+  return duration_;
+}
+
+int Interchangeability::num_iterations() const {
+  return num_iterations_;
+}
+
+int Interchangeability::num_processed() const {
+  return num_merged_;
+}
+
+}  // namespace ace
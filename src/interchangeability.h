@@ -0,0 +1,71 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#ifndef SRC_INTERCHANGEABILITY_H_
+#define SRC_INTERCHANGEABILITY_H_
+
+#include <cstdint>
+#include <vector>
+#include "./preprocessor.h"
+#include "./clock.h"
+
+namespace ace {
+
+class Network;
+class Assignment;
+class SolutionSink;
+
+// Neighbourhood interchangeability preprocessor. Values of a variable with
+// identical support rows in all of its constraints are interchangeable in
+// every solution. Each class of such values is merged into its first value,
+// the others are removed from the domain and restored by expanding the
+// solutions.
+class Interchangeability : public Preprocessor {
+ public:
+  // Initializes preprocessor with given network.
+  explicit Interchangeability(Network* network);
+
+  // Merges the neighbourhood interchangeable values of all variables.
+  // Returns whether the network is consistent, which is always the case.
+  bool Preprocess();
+
+  // Passes all solutions represented by the given solution to the sink one at
+  // a time, up to the given maximum number of solutions.
+  void Expand(const Assignment& solution, const int64_t max_num_solutions,
+              SolutionSink* sink) const;
+
+  // Returns the number of solutions represented by the given solution.
+  double num_expansions(const Assignment& solution) const;
+
+  // Returns the duration in microseconds of the last call to preprocess.
+  base::Clock::Diff duration() const;
+
+  // Returns the number of variables processed by the last call to preprocess.
+  int num_iterations() const;
+
+  // Returns the number of values merged by the last call to preprocess.
+  int num_processed() const;
+
+ private:
+  // Fills the given row with the supports of the value (by id) in all
+  // constraints of the variable.
+  void SupportRow(const int var_id, const int value,
+                  std::vector<bool>* row) const;
+
+  // Recursively substitutes the merged values of the variables starting at
+  // given index, decrementing the remaining number of solutions for each
+  // solution passed to the sink.
+  void ExpandRec(const int var_index, Assignment* assignment,
+                 int64_t* num_remaining, SolutionSink* sink) const;
+
+  Network* network_;
+  // The merged values (by id) for each representative value by variable,
+  // empty for the values without merged ones.
+  std::vector<std::vector<std::vector<int> > > classes_;
+  // The variables with merged values.
+  std::vector<int> merged_variables_;
+  int num_iterations_;
+  int num_merged_;
+  base::Clock::Diff duration_;
+};
+
+}  // namespace ace
+#endif  // SRC_INTERCHANGEABILITY_H_
@@ -1,50 +1,63 @@
 // Copyright 2012 Eugen Sawin <esawin@me73.com>
 #include "./max-cardinality-ordering.h"
 #include <cassert>
-#include <queue>
 #include <vector>
-#include <set>
+#include <algorithm>
+#include <functional>
 #include "./network.h"
 
-using std::priority_queue;
-using std::pair;
-using std::make_pair;
 using std::vector;
-using std::set;
+using std::max;
+using std::push_heap;
+using std::pop_heap;
+using std::greater;
 
 namespace ace {
 
-struct PairLess {
-  bool operator()(const pair<int, int>& lhs, const pair<int, int>& rhs) const {
-    return lhs.first < rhs.first ||
-           (lhs.first == rhs.first && lhs.second > rhs.second);
-  }
-};
-
 MaxCardinalityOrdering::MaxCardinalityOrdering(const Network& network)
     : network_(network) {}
 
 vector<int> MaxCardinalityOrdering::CreateOrdering() const {
-  typedef priority_queue<pair<int, int>,
-                         vector<pair<int, int> >,
-                         PairLess> Queue;
-
   const int num_variables = network_.num_variables();
   vector<int> ordering;
   ordering.reserve(num_variables);
+  // The cardinality of a variable is bound by its degree.
+  int max_cardinality = 0;
+  for (int i = 0; i < num_variables; ++i) {
+    const vector<int>& cons = network_.constraints(i);
+    int degree = 0;
+    for (auto it = cons.cbegin(), end = cons.cend(); it != end; ++it) {
+      degree += network_.constraint(*it).arity() - 1;
+    }
+    max_cardinality = max(max_cardinality, degree);
+  }
 
-  Queue q;
+  // Bucket queue indexed by cardinality. Each bucket is a min-heap of variable
+  // ids to select the smallest id among variables of equal cardinality.
+  // Variables are not removed from their old bucket when their cardinality
+  // rises, stale entries are skipped instead.
+  vector<vector<int> > buckets(max_cardinality + 1);
   for (int i = 0; i < num_variables; ++i) {
-    q.push(make_pair(0, i));
+    // Ascending ids form a valid min-heap.
+    buckets[0].push_back(i);
   }
 
   vector<int> cardinalities(num_variables, 0);
   vector<bool> ordered(num_variables, false);
+  int top_cardinality = 0;
   while (static_cast<int>(ordering.size()) < num_variables) {
-    // const int cardinality = q.top().first;
-    const int var_id = q.top().second;
-    q.pop();
-    if (ordered[var_id]) {
+    assert(top_cardinality >= 0);
+    vector<int>& bucket = buckets[top_cardinality];
+    if (bucket.empty()) {
+      --top_cardinality;
+      continue;
+    }
+    pop_heap(bucket.begin(), bucket.end(), greater<int>());
+    const int var_id = bucket.back();
+    bucket.pop_back();
+    if (ordered[var_id] || cardinalities[var_id] != top_cardinality) {
+      // Stale entry.
+      assert(ordered[var_id] || cardinalities[var_id] > top_cardinality);
       continue;
     }
     ordering.push_back(var_id);
@@ -55,15 +68,16 @@ vector<int> MaxCardinalityOrdering::CreateOrdering() const {
       const vector<int>& scope = constraint.scope();
       for (auto it2 = scope.cbegin(), end2 = scope.cend();
            it2 != end2; ++it2) {
-        ++cardinalities[*it2];
-      }
-    }
-    for (auto it = cons.cbegin(), end = cons.cend(); it != end; ++it) {
-      const Constraint& constraint = network_.constraint(*it);
-      const vector<int>& scope = constraint.scope();
-      for (auto it2 = scope.cbegin(), end2 = scope.cend();
-           it2 != end2; ++it2) {
-        q.push(make_pair(cardinalities[*it2], *it2));
+        const int neigh_id = *it2;
+        if (ordered[neigh_id]) {
+          continue;
+        }
+        const int cardinality = ++cardinalities[neigh_id];
+        assert(cardinality <= max_cardinality);
+        vector<int>& neigh_bucket = buckets[cardinality];
+        neigh_bucket.push_back(neigh_id);
+        push_heap(neigh_bucket.begin(), neigh_bucket.end(), greater<int>());
+        top_cardinality = max(top_cardinality, cardinality);
       }
     }
   }
@@ -0,0 +1,295 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include "./max-csp-solver.h"
+#include <cassert>
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include "./clock.h"
+#include "./network.h"
+#include "./solution-sink.h"
+#include "./variable-ordering.h"
+#include "./tabu-solver.h"
+
+using std::vector;
+using std::pair;
+using std::make_pair;
+using std::numeric_limits;
+using std::min;
+using std::max;
+using std::sort;
+using base::Clock;
+
+namespace ace {
+
+const int MaxCspSolver::kDefInitialStepsPerVariable = 100;
+
+MaxCspSolver::MaxCspSolver(Network* network)
+    : Solver(),
+      network_(*network),
+      target_(0),
+      time_limit_(Solver::kDefTimeLimit) {
+  Reset();
+  // Set the lexicographical variable ordering.
+  const int num_vars = network_.num_variables();
+  var_ordering_.resize(num_vars, 0);
+  for (int i = 0; i < num_vars; ++i) {
+    var_ordering_[i] = i;
+  }
+}
+
+bool MaxCspSolver::Solve() {
+  Reset();
+  begin_clock_ = Clock(clock_type_);
+  solutions_.clear();
+  num_solutions_ = 0;
+  const int num_vars = network_.num_variables();
+  positions_.resize(num_vars);
+  domains_.resize(num_vars);
+  ic_.resize(num_vars);
+  for (int i = 0; i < num_vars; ++i) {
+    const int var_id = var_ordering_[i];
+    positions_[var_id] = i;
+    const Variable& var = network_.variable(var_id);
+    domains_[var_id] = var.valid_value_ids();
+    ic_[var_id].assign(var.num_values(), 0);
+  }
+  InitDac();
+  upper_bound_ = network_.num_constraints() + 1;
+  InitUpperBound();
+  if (upper_bound_ > target_) {
+    Assignment assignment(network_);
+    SolveRec(0, 0, &assignment);
+  }
+  duration_ = Clock(clock_type_) - begin_clock_;
+  return solutions_.size();
+}
+
+void MaxCspSolver::InitUpperBound() {
+  TabuSolver tabu_solver(&network_);
+  tabu_solver.max_num_steps(kDefInitialStepsPerVariable *
+                            network_.num_variables());
+  tabu_solver.time_limit(time_limit_ / 10);
+  tabu_solver.Solve();
+  if (tabu_solver.num_steps() || tabu_solver.num_solutions()) {
+    AddImprovement(tabu_solver.best_assignment(),
+                   tabu_solver.best_num_violated());
+  }
+}
+
+void MaxCspSolver::AddImprovement(const Assignment& assignment,
+                                  const int num_violated) {
+  assert(num_violated < upper_bound_);
+  assert(num_violated == assignment.num_violated_constraints());
+  upper_bound_ = num_violated;
+  ++num_improvements_;
+  solutions_.assign(1, assignment);
+  ++num_solutions_;
+  if (sink_) {
+    sink_->Add(assignment);
+  }
+}
+
+void MaxCspSolver::InitDac() {
+  const int num_vars = network_.num_variables();
+  dac_.resize(num_vars);
+  for (int var_id = 0; var_id < num_vars; ++var_id) {
+    dac_[var_id].assign(network_.variable(var_id).num_values(), 0);
+    const vector<int>& constraints = network_.constraints(var_id);
+    for (auto it = constraints.cbegin(), end = constraints.cend();
+         it != end; ++it) {
+      const Constraint& constraint = network_.constraint(*it);
+      assert(constraint.arity() == 2);
+      const int neighbour = constraint.scope(0) == var_id ?
+                            constraint.scope(1) : constraint.scope(0);
+      if (positions_[neighbour] < positions_[var_id]) {
+        // Only constraints directed to later variables are counted.
+        continue;
+      }
+      const vector<int>& domain = domains_[var_id];
+      const vector<int>& neighbour_domain = domains_[neighbour];
+      for (auto it2 = domain.cbegin(), end2 = domain.cend();
+           it2 != end2; ++it2) {
+        bool supported = false;
+        for (auto it3 = neighbour_domain.cbegin(),
+             end3 = neighbour_domain.cend(); !supported && it3 != end3; ++it3) {
+          supported = !Conflicts(*it, var_id, *it2, *it3);
+        }
+        dac_[var_id][*it2] += !supported;
+      }
+    }
+  }
+}
+
+bool MaxCspSolver::SolveRec(const int depth, const int distance,
+                            Assignment* assignment) {
+  const int num_vars = var_ordering_.size();
+  if (depth == num_vars) {
+    // Improving assignment found.
+    AddImprovement(*assignment, distance);
+    return upper_bound_ <= target_;
+  } else if (cancelled_ || Clock(clock_type_) - begin_clock_ > time_limit_) {
+    // Time limit reached or search cancelled.
+    timeout_ = true;
+    return true;
+  }
+  const int var_id = var_ordering_[depth];
+  const vector<int>& ic = ic_[var_id];
+  const vector<int>& dac = dac_[var_id];
+  // Try the values with the lowest costs first.
+  vector<pair<int, int> > values;
+  const vector<int>& domain = domains_[var_id];
+  values.reserve(domain.size());
+  for (auto it = domain.cbegin(), end = domain.cend(); it != end; ++it) {
+    values.push_back(make_pair(ic[*it] + dac[*it], *it));
+  }
+  sort(values.begin(), values.end());
+  const int future_bound = FutureLowerBound(depth + 1);
+  const vector<int>& constraints = network_.constraints(var_id);
+  for (auto it = values.cbegin(), end = values.cend(); it != end; ++it) {
+    const int value = it->second;
+    ++num_explored_states_;
+    if (distance + it->first + future_bound >= upper_bound_) {
+      // The remaining values are at least as costly.
+      ++num_backtracks_;
+      break;
+    }
+    assignment->Assign(var_id, value);
+    // Update the inconsistency counts of the future neighbours.
+    for (auto it2 = constraints.cbegin(), end2 = constraints.cend();
+         it2 != end2; ++it2) {
+      const Constraint& constraint = network_.constraint(*it2);
+      const int neighbour = constraint.scope(0) == var_id ?
+                            constraint.scope(1) : constraint.scope(0);
+      if (positions_[neighbour] > depth) {
+        vector<int>& neighbour_ic = ic_[neighbour];
+        const vector<int>& neighbour_domain = domains_[neighbour];
+        for (auto it3 = neighbour_domain.cbegin(),
+             end3 = neighbour_domain.cend(); it3 != end3; ++it3) {
+          neighbour_ic[*it3] += Conflicts(*it2, var_id, value, *it3);
+        }
+      }
+    }
+    const int new_distance = distance + ic[value];
+    bool stop = false;
+    if (new_distance + FutureLowerBound(depth + 1) < upper_bound_) {
+      stop = SolveRec(depth + 1, new_distance, assignment);
+    } else {
+      ++num_backtracks_;
+    }
+    // Revert the inconsistency counts.
+    for (auto it2 = constraints.cbegin(), end2 = constraints.cend();
+         it2 != end2; ++it2) {
+      const Constraint& constraint = network_.constraint(*it2);
+      const int neighbour = constraint.scope(0) == var_id ?
+                            constraint.scope(1) : constraint.scope(0);
+      if (positions_[neighbour] > depth) {
+        vector<int>& neighbour_ic = ic_[neighbour];
+        const vector<int>& neighbour_domain = domains_[neighbour];
+        for (auto it3 = neighbour_domain.cbegin(),
+             end3 = neighbour_domain.cend(); it3 != end3; ++it3) {
+          neighbour_ic[*it3] -= Conflicts(*it2, var_id, value, *it3);
+        }
+      }
+    }
+    assignment->Revert();
+    if (stop) {
+      return true;
+    }
+  }
+  return false;
+}
+
+int MaxCspSolver::FutureLowerBound(const int depth) const {
+  const int num_vars = var_ordering_.size();
+  int bound = 0;
+  for (int i = depth; i < num_vars; ++i) {
+    const int var_id = var_ordering_[i];
+    const vector<int>& ic = ic_[var_id];
+    const vector<int>& dac = dac_[var_id];
+    const vector<int>& domain = domains_[var_id];
+    int min_cost = numeric_limits<int>::max();
+    for (auto it = domain.cbegin(), end = domain.cend(); it != end; ++it) {
+      min_cost = min(min_cost, ic[*it] + dac[*it]);
+    }
+    bound += min_cost;
+  }
+  return bound;
+}
+
+bool MaxCspSolver::Conflicts(const int constraint_id, const int var1,
+                             const int value1, const int value2) const {
+  const Constraint& constraint = network_.constraint(constraint_id);
+  tuple_.resize(2);
+  if (constraint.scope(0) == var1) {
+    tuple_[0] = value1;
+    tuple_[1] = value2;
+  } else {
+    tuple_[0] = value2;
+    tuple_[1] = value1;
+  }
+  return constraint.Conflicts(tuple_);
+}
+
+void MaxCspSolver::Reset() {
+  duration_ = 0;
+  num_improvements_ = 0;
+  num_backtracks_ = 0;
+  num_explored_states_ = 0.0;
+  timeout_ = false;
+}
+
+void MaxCspSolver::variable_ordering(const VariableOrdering& var_ordering) {
+  var_ordering_ = var_ordering.CreateOrdering();
+}
+
+void MaxCspSolver::target(const int num) {
+  target_ = max(0, num);
+}
+
+int MaxCspSolver::target() const {
+  return target_;
+}
+
+void MaxCspSolver::time_limit(const Clock::Diff& limit) {
+  time_limit_ = min(limit, Solver::kDefTimeLimit);
+}
+
+Clock::Diff MaxCspSolver::time_limit() const {
+  return time_limit_;
+}
+
+void MaxCspSolver::max_num_solutions(const int num) {}
+
+int MaxCspSolver::max_num_solutions() const {
+  return 1;
+}
+
+const vector<Assignment>& MaxCspSolver::solutions() const {
+  return solutions_;
+}
+
+Clock::Diff MaxCspSolver::duration() const {
+  return duration_;
+}
+
+bool MaxCspSolver::optimal() const {
+  return solutions_.size() && !timeout_;
+}
+
+int MaxCspSolver::best_num_violated() const {
+  return upper_bound_;
+}
+
+int MaxCspSolver::num_improvements() const {
+  return num_improvements_;
+}
+
+int MaxCspSolver::num_backtracks() const {
+  return num_backtracks_;
+}
+
+double MaxCspSolver::num_explored_states() const {
+  return num_explored_states_;
+}
+
+}  // namespace ace
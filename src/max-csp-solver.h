@@ -0,0 +1,132 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#ifndef SRC_MAX_CSP_SOLVER_H_
+#define SRC_MAX_CSP_SOLVER_H_
+
+#include <vector>
+#include "./solver.h"
+#include "./clock.h"
+#include "./assignment.h"
+
+namespace ace {
+
+// The constraint network.
+class Network;
+
+// The variable ordering.
+class VariableOrdering;
+
+// A Max-CSP solver based on depth-first branch and bound, which searches for
+// the complete assignment violating the fewest constraints. The initial upper
+// bound is given by a short tabu search. The lower bound
+// combines the violations of the partial assignment with the inconsistency
+// counts of the future values (IC) and the static directed arc-inconsistency
+// counts along the variable ordering (DAC), as in PFC-DAC. Each improving
+// assignment is passed to the solution sink as it is found, which makes the
+// search anytime. Only binary constraints are supported.
+class MaxCspSolver : public Solver {
+ public:
+  static const int kDefInitialStepsPerVariable;
+
+  // Initialises the solver with the given network.
+  explicit MaxCspSolver(Network* network);
+
+  // Searches for the assignment with the fewest violated constraints.
+  // Returns whether it found a complete assignment.
+  bool Solve();
+
+  // Resets the solver meta-information, which is collected during search.
+  void Reset();
+
+  // Sets the variable ordering.
+  void variable_ordering(const VariableOrdering& var_ordering);
+
+  // Sets the number of violated constraints at which the search stops, e.g.
+  // a known optimum.
+  void target(const int num);
+
+  // Returns the set target number of violated constraints.
+  int target() const;
+
+  // Sets the time limit for the search. Search will be terminated if the time
+  // limit is exceeded, keeping the best assignment found.
+  void time_limit(const base::Clock::Diff& limit);
+
+  // Returns the set time limit.
+  base::Clock::Diff time_limit() const;
+
+  // Ignored, only the best assignment is kept.
+  void max_num_solutions(const int num);
+
+  // Returns 1, only the best assignment is kept.
+  int max_num_solutions() const;
+
+  // Returns a const reference to the best assignment found by the last search,
+  // empty if none was found.
+  const std::vector<Assignment>& solutions() const;
+
+  // Returns the duration of the last search in microseconds.
+  base::Clock::Diff duration() const;
+
+  // Returns whether the best assignment of the last search is proven optimal.
+  bool optimal() const;
+
+  // Returns the number of violated constraints of the best assignment.
+  int best_num_violated() const;
+
+  // Returns the number of improving assignments found during the last search.
+  int num_improvements() const;
+
+  // Returns the number of pruned branches during the last search.
+  int num_backtracks() const;
+
+  // Returns the number of states explored during the last search.
+  double num_explored_states() const;
+
+ private:
+  // Finds an initial assignment with few violations using tabu search.
+  void InitUpperBound();
+
+  // Records the improving assignment.
+  void AddImprovement(const Assignment& assignment, const int num_violated);
+
+  // Computes the directed arc-inconsistency counts along the ordering.
+  void InitDac();
+
+  // Returns whether the binary constraint is violated by the two values (by
+  // id) of its scope variables, given in any order.
+  bool Conflicts(const int constraint_id, const int var1, const int value1,
+                 const int value2) const;
+
+  // Returns the sum of the minimum value costs of the future variables
+  // starting at given ordering position.
+  int FutureLowerBound(const int depth) const;
+
+  // Branches on the variable at given ordering position.
+  // Returns true if the search should stop.
+  bool SolveRec(const int depth, const int distance, Assignment* assignment);
+
+  Network& network_;
+  std::vector<int> var_ordering_;
+  std::vector<int> positions_;
+  std::vector<std::vector<int> > domains_;
+  // The number of violated constraints with past variables, indexed by
+  // variable and value.
+  std::vector<std::vector<int> > ic_;
+  // The number of future variables without compatible values, indexed by
+  // variable and value.
+  std::vector<std::vector<int> > dac_;
+  std::vector<Assignment> solutions_;
+  mutable std::vector<int> tuple_;
+  int upper_bound_;
+  int target_;
+  int num_improvements_;
+  int num_backtracks_;
+  double num_explored_states_;
+  bool timeout_;
+  base::Clock begin_clock_;
+  base::Clock::Diff duration_;
+  base::Clock::Diff time_limit_;
+};
+
+}  // namespace ace
+#endif  // SRC_MAX_CSP_SOLVER_H_
@@ -0,0 +1,167 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include "./min-fill-ordering.h"
+#include <cassert>
+#include <cstdint>
+#include <set>
+#include <vector>
+#include <algorithm>
+#include "./network.h"
+
+using std::set;
+using std::pair;
+using std::make_pair;
+using std::vector;
+using std::reverse;
+using std::find;
+
+namespace ace {
+
+// Marks the neighbours of given variable with a new stamp.
+// Returns the stamp.
+static int MarkNeighbours(const vector<vector<int> >& graph, const int var_id,
+                          int* stamp, vector<int>* marks) {
+  ++*stamp;
+  const vector<int>& neighs = graph[var_id];
+  for (auto it = neighs.cbegin(), end = neighs.cend(); it != end; ++it) {
+    (*marks)[*it] = *stamp;
+  }
+  return *stamp;
+}
+
+// Returns the number of neighbours of given variable carrying the stamp.
+static int NumMarked(const vector<vector<int> >& graph, const int var_id,
+                     const int stamp, const vector<int>& marks) {
+  const vector<int>& neighs = graph[var_id];
+  int num_marked = 0;
+  for (auto it = neighs.cbegin(), end = neighs.cend(); it != end; ++it) {
+    num_marked += marks[*it] == stamp;
+  }
+  return num_marked;
+}
+
+MinFillOrdering::MinFillOrdering(const Network& network,
+                                 const int64_t max_num_fill_edges)
+    : network_(network),
+      max_num_fill_edges_(max_num_fill_edges) {}
+
+vector<int> MinFillOrdering::CreateOrdering() const {
+  const int num_variables = network_.num_variables();
+  vector<int> ordering;
+  ordering.reserve(num_variables);
+  // Unordered adjacency lists, the eliminated variables are removed and the
+  // fill-in edges added.
+  vector<vector<int> > graph(num_variables);
+  {
+    const vector<set<int> > primal = VariableOrdering::PrimalGraph(network_);
+    for (int i = 0; i < num_variables; ++i) {
+      graph[i].assign(primal[i].begin(), primal[i].end());
+    }
+  }
+  vector<int> marks(num_variables, 0);
+  int stamp = 0;
+
+  // The number of fill edges is the number of neighbour pairs minus the
+  // number of adjacent neighbour pairs, each counted from both sides.
+  vector<int64_t> num_fill_edges(num_variables, 0);
+  for (int i = 0; i < num_variables; ++i) {
+    const int64_t degree = graph[i].size();
+    const int s = MarkNeighbours(graph, i, &stamp, &marks);
+    int64_t num_adjacent = 0;
+    for (auto it = graph[i].cbegin(), end = graph[i].cend(); it != end; ++it) {
+      num_adjacent += NumMarked(graph, *it, s, marks);
+    }
+    num_fill_edges[i] = degree * (degree - 1) / 2 - num_adjacent / 2;
+  }
+
+  // Ordered by number of fill edges and variable id, with the keys of the
+  // queued entries.
+  set<pair<int64_t, int> > q;
+  vector<int64_t> keys(num_fill_edges);
+  for (int i = 0; i < num_variables; ++i) {
+    q.insert(make_pair(keys[i], i));
+  }
+  // The variables with changed fill counts during an elimination.
+  vector<int> changed;
+  vector<bool> is_changed(num_variables, false);
+  int64_t num_added = 0;
+
+  while (q.size()) {
+    const int var_id = q.begin()->second;
+    q.erase(q.begin());
+    ordering.push_back(var_id);
+    const vector<int> neighs = graph[var_id];
+    graph[var_id].clear();
+    const int num_neighs = neighs.size();
+    for (int i = 0; i < num_neighs; ++i) {
+      if (!is_changed[neighs[i]]) {
+        is_changed[neighs[i]] = true;
+        changed.push_back(neighs[i]);
+      }
+    }
+    // Remove the variable, its neighbours lose the missing edges to it.
+    int s = ++stamp;
+    for (int i = 0; i < num_neighs; ++i) {
+      marks[neighs[i]] = s;
+    }
+    for (int i = 0; i < num_neighs; ++i) {
+      const int u = neighs[i];
+      vector<int>& neighs_u = graph[u];
+      auto pos = find(neighs_u.begin(), neighs_u.end(), var_id);
+      assert(pos != neighs_u.end());
+      *pos = neighs_u.back();
+      neighs_u.pop_back();
+      num_fill_edges[u] -= static_cast<int64_t>(neighs_u.size()) -
+                           NumMarked(graph, u, s, marks);
+    }
+    // Connect all its neighbours. A fill edge (a, b) adds the missing edges
+    // to the new neighbour and removes one missing edge of every common
+    // neighbour.
+    for (int i = 0; i < num_neighs; ++i) {
+      const int a = neighs[i];
+      s = MarkNeighbours(graph, a, &stamp, &marks);
+      for (int j = i + 1; j < num_neighs; ++j) {
+        const int b = neighs[j];
+        if (marks[b] == s) {
+          continue;
+        }
+        int num_common = 0;
+        const vector<int>& neighs_b = graph[b];
+        for (auto it = neighs_b.cbegin(), end = neighs_b.cend();
+             it != end; ++it) {
+          if (marks[*it] == s) {
+            ++num_common;
+            --num_fill_edges[*it];
+            if (!is_changed[*it]) {
+              is_changed[*it] = true;
+              changed.push_back(*it);
+            }
+          }
+        }
+        num_fill_edges[a] += static_cast<int64_t>(graph[a].size()) - num_common;
+        num_fill_edges[b] += static_cast<int64_t>(graph[b].size()) - num_common;
+        graph[a].push_back(b);
+        graph[b].push_back(a);
+        marks[b] = s;
+        if (++num_added == max_num_fill_edges_) {
+          return vector<int>();
+        }
+      }
+    }
+    // Requeue the variables with changed fill counts.
+    for (auto it = changed.cbegin(), end = changed.cend(); it != end; ++it) {
+      const int id = *it;
+      is_changed[id] = false;
+      if (keys[id] != num_fill_edges[id]) {
+        assert(q.count(make_pair(keys[id], id)));
+        q.erase(make_pair(keys[id], id));
+        keys[id] = num_fill_edges[id];
+        q.insert(make_pair(keys[id], id));
+      }
+    }
+    changed.clear();
+  }
+  reverse(ordering.begin(), ordering.end());
+  return ordering;
+}
+
+}  // namespace ace
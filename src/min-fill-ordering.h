@@ -0,0 +1,30 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#ifndef SRC_MIN_FILL_ORDERING_H_
+#define SRC_MIN_FILL_ORDERING_H_
+
+#include <cstdint>
+#include <vector>
+#include "./variable-ordering.h"
+
+namespace ace {
+
+class Network;
+
+// Orders the variables by greedily eliminating the variable which adds the
+// fewest fill-in edges to the primal graph, ties are broken by the smallest
+// variable id. The search ordering is the reversed elimination ordering.
+class MinFillOrdering : public VariableOrdering {
+ public:
+  // Initializes the ordering for given network. The elimination gives up once
+  // it adds more than the given number of fill edges and creates an empty
+  // ordering, 0 for no limit.
+  explicit MinFillOrdering(const Network& network,
+                           const int64_t max_num_fill_edges = 0);
+  std::vector<int> CreateOrdering() const;
+ private:
+  const Network& network_;
+  int64_t max_num_fill_edges_;
+};
+
+}  // namespace ace
+#endif  // SRC_MIN_FILL_ORDERING_H_
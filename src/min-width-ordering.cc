@@ -1,58 +1,63 @@
 // Copyright 2012 Eugen Sawin <esawin@me73.com>
 #include "./min-width-ordering.h"
 #include <cassert>
-#include <queue>
 #include <vector>
 #include <algorithm>
+#include <functional>
 #include "./network.h"
 
-using std::priority_queue;
-using std::pair;
-using std::make_pair;
-using std::greater;
 using std::vector;
 using std::reverse;
+using std::max;
+using std::push_heap;
+using std::pop_heap;
+using std::greater;
 
 namespace ace {
 
-struct PairGreater {
-  bool operator()(const pair<int, int>& lhs, const pair<int, int>& rhs) const {
-    return lhs.first > rhs.first ||
-           (lhs.first == rhs.first && lhs.second > rhs.second);
-  }
-};
-
 MinWidthOrdering::MinWidthOrdering(const Network& network)
     : network_(network) {}
 
 vector<int> MinWidthOrdering::CreateOrdering() const {
-  typedef priority_queue<pair<int, int>,
-                         vector<pair<int, int> >,
-                         PairGreater> Queue;
-
   const int num_variables = network_.num_variables();
   vector<int> ordering;
   ordering.reserve(num_variables);
   vector<int> degrees(num_variables, 0);
-
-  Queue q;
+  int max_degree = 0;
   for (int i = 0; i < num_variables; ++i) {
     const vector<int>& cons = network_.constraints(i);
     for (auto it = cons.begin(), end = cons.end(); it != end; ++it) {
       const Constraint& con = network_.constraint(*it);
       degrees[i] += con.arity() - 1;
     }
-    q.push(make_pair(degrees[i], i));
+    max_degree = max(max_degree, degrees[i]);
+  }
+
+  // Bucket queue indexed by degree. Each bucket is a min-heap of variable ids
+  // to select the smallest id among variables of equal degree. Variables are
+  // not removed from their old bucket when their degree drops, stale entries
+  // are skipped instead.
+  vector<vector<int> > buckets(max_degree + 1);
+  for (int i = 0; i < num_variables; ++i) {
+    // Ascending ids form a valid min-heap.
+    buckets[degrees[i]].push_back(i);
   }
 
   vector<bool> ordered(num_variables, false);
+  int min_degree = 0;
   while (static_cast<int>(ordering.size()) < num_variables) {
-    const int degree = q.top().first;
-    const int var_id = q.top().second;
-    q.pop();
-    assert(degree >= 0);
-    if (ordered[var_id]) {
-      assert(degrees[var_id] <= degree);
+    assert(min_degree <= max_degree);
+    vector<int>& bucket = buckets[min_degree];
+    if (bucket.empty()) {
+      ++min_degree;
+      continue;
+    }
+    pop_heap(bucket.begin(), bucket.end(), greater<int>());
+    const int var_id = bucket.back();
+    bucket.pop_back();
+    if (ordered[var_id] || degrees[var_id] != min_degree) {
+      // Stale entry.
+      assert(ordered[var_id] || degrees[var_id] < min_degree);
       continue;
     }
     ordering.push_back(var_id);
@@ -63,10 +68,17 @@ vector<int> MinWidthOrdering::CreateOrdering() const {
       const int arity = con.arity();
       for (int i = 0; i < arity; ++i) {
         const int neigh_id = con.scope(i);
-        if (neigh_id == var_id) {
+        if (neigh_id == var_id || ordered[neigh_id]) {
           continue;
         }
-        q.push(make_pair(--degrees[neigh_id], neigh_id));
+        const int degree = --degrees[neigh_id];
+        assert(degree >= 0);
+        vector<int>& neigh_bucket = buckets[degree];
+        neigh_bucket.push_back(neigh_id);
+        push_heap(neigh_bucket.begin(), neigh_bucket.end(), greater<int>());
+        if (degree < min_degree) {
+          min_degree = degree;
+        }
       }
     }
   }
@@ -0,0 +1,217 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include "./multi-walk-solver.h"
+#include <cassert>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include "./clock.h"
+#include "./network.h"
+#include "./solution-sink.h"
+
+using std::vector;
+using std::thread;
+using std::mutex;
+using std::lock_guard;
+using std::min;
+using base::Clock;
+
+namespace ace {
+
+const uint32_t MultiWalkSolver::kDefSeed = 0x5a8aff10;
+
+// Winner id used while no walk has found a solution.
+static const int kNoWinner = -1;
+
+MultiWalkSolver::MultiWalkSolver(const Network& network,
+                                 const int num_walkers, const uint32_t seed)
+    : Solver(),
+      time_limit_(Solver::kDefTimeLimit),
+      max_num_solutions_(Solver::kDefMaxNumSolutions) {
+  assert(num_walkers > 0);
+  for (int w = 0; w < num_walkers; ++w) {
+    networks_.push_back(new Network(network));
+    walkers_.push_back(new RandomWalkSolver(networks_.back()));
+    walkers_.back()->seed(seed + w);
+  }
+  Reset();
+}
+
+MultiWalkSolver::~MultiWalkSolver() {
+  for (auto it = walkers_.begin(), end = walkers_.end(); it != end; ++it) {
+    delete *it;
+  }
+  for (auto it = networks_.begin(), end = networks_.end(); it != end; ++it) {
+    delete *it;
+  }
+}
+
+bool MultiWalkSolver::Solve() {
+  Reset();
+  const Clock begin_clock(Clock::kWallTime);
+  const int num_walkers = walkers_.size();
+  num_running_ = num_walkers;
+  vector<thread> threads;
+  threads.reserve(num_walkers);
+  for (int w = 0; w < num_walkers; ++w) {
+    threads.push_back(thread(&MultiWalkSolver::Run, this, w));
+  }
+  {
+    // The time limit is enforced in wall time here.
+    std::unique_lock<mutex> lock(mutex_);
+    auto all_finished = [this] { return num_running_ == 0; };
+    if (time_limit_ >= Solver::kMaxWaitTime) {
+      finished_.wait(lock, all_finished);
+    } else if (!finished_.wait_for(lock,
+                                   std::chrono::microseconds(time_limit_),
+                                   all_finished)) {
+      lock.unlock();
+      Cancel();
+    }
+  }
+  for (auto it = threads.begin(), end = threads.end(); it != end; ++it) {
+    it->join();
+  }
+  duration_ = Clock(Clock::kWallTime) - begin_clock;
+  if (winner_ == kNoWinner) {
+    num_solutions_ = 0;
+    return false;
+  }
+  const vector<Assignment>& solutions = walkers_[winner_]->solutions();
+  num_solutions_ = solutions.size();
+  if (sink_) {
+    // Only the solutions of the winning walk are passed to the sink.
+    for (auto it = solutions.cbegin(), end = solutions.cend();
+         it != end; ++it) {
+      sink_->Add(*it);
+    }
+  }
+  return true;
+}
+
+bool MultiWalkSolver::complete() const {
+  return false;
+}
+
+void MultiWalkSolver::Run(const int walker_id) {
+  RandomWalkSolver* walker = walkers_[walker_id];
+  // The time limit is enforced in wall time by cancelling the walks.
+  walker->time_limit(Solver::kDefTimeLimit);
+  walker->max_num_solutions(max_num_solutions_);
+  const bool sat = walker->Solve();
+  lock_guard<mutex> lock(mutex_);
+  --num_running_;
+  finished_.notify_one();
+  if (sat) {
+    if (winner_ == kNoWinner) {
+      winner_ = walker_id;
+      const int num_walkers = walkers_.size();
+      for (int w = 0; w < num_walkers; ++w) {
+        if (w != walker_id) {
+          walkers_[w]->Cancel();
+        }
+      }
+    }
+  }
+}
+
+void MultiWalkSolver::Cancel() {
+  Solver::Cancel();
+  for (auto it = walkers_.begin(), end = walkers_.end(); it != end; ++it) {
+    (*it)->Cancel();
+  }
+}
+
+void MultiWalkSolver::Reset() {
+  winner_ = kNoWinner;
+  duration_ = 0;
+}
+
+void MultiWalkSolver::max_num_tries(const int n) {
+  for (auto it = walkers_.begin(), end = walkers_.end(); it != end; ++it) {
+    (*it)->max_num_tries(n);
+  }
+}
+
+void MultiWalkSolver::max_num_flips(const int n) {
+  for (auto it = walkers_.begin(), end = walkers_.end(); it != end; ++it) {
+    (*it)->max_num_flips(n);
+  }
+}
+
+void MultiWalkSolver::random_probability(const int p) {
+  for (auto it = walkers_.begin(), end = walkers_.end(); it != end; ++it) {
+    (*it)->random_probability(p);
+  }
+}
+
+void MultiWalkSolver::share_best(const bool share) {
+  for (auto it = walkers_.begin(), end = walkers_.end(); it != end; ++it) {
+    (*it)->shared_assignment(share ? &shared_ : nullptr);
+  }
+}
+
+void MultiWalkSolver::time_limit(const Clock::Diff& limit) {
+  time_limit_ = min(limit, Solver::kDefTimeLimit);
+}
+
+Clock::Diff MultiWalkSolver::time_limit() const {
+  return time_limit_;
+}
+
+void MultiWalkSolver::max_num_solutions(const int num) {
+  max_num_solutions_ = num > 0 ? num : Solver::kDefMaxNumSolutions;
+}
+
+int MultiWalkSolver::max_num_solutions() const {
+  return max_num_solutions_;
+}
+
+const vector<Assignment>& MultiWalkSolver::solutions() const {
+  if (winner_ == kNoWinner) {
+    return no_solutions_;
+  }
+  return walkers_[winner_]->solutions();
+}
+
+Clock::Diff MultiWalkSolver::duration() const {
+  return duration_;
+}
+
+int MultiWalkSolver::num_random_steps() const {
+  int num_steps = 0;
+  for (auto it = walkers_.cbegin(), end = walkers_.cend(); it != end; ++it) {
+    num_steps += (*it)->num_random_steps();
+  }
+  return num_steps;
+}
+
+int MultiWalkSolver::num_greedy_steps() const {
+  int num_steps = 0;
+  for (auto it = walkers_.cbegin(), end = walkers_.cend(); it != end; ++it) {
+    num_steps += (*it)->num_greedy_steps();
+  }
+  return num_steps;
+}
+
+int MultiWalkSolver::num_backtracks() const {
+  return 0;
+}
+
+double MultiWalkSolver::num_explored_states() const {
+  double num_explored_states = 0.0;
+  for (auto it = walkers_.cbegin(), end = walkers_.cend(); it != end; ++it) {
+    num_explored_states += (*it)->num_explored_states();
+  }
+  return num_explored_states;
+}
+
+int MultiWalkSolver::winner() const {
+  return winner_;
+}
+
+int MultiWalkSolver::num_walkers() const {
+  return walkers_.size();
+}
+
+}  // namespace ace
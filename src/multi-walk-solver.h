@@ -0,0 +1,109 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#ifndef SRC_MULTI_WALK_SOLVER_H_
+#define SRC_MULTI_WALK_SOLVER_H_
+
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+#include "./solver.h"
+#include "./clock.h"
+#include "./assignment.h"
+#include "./network.h"
+#include "./random-walk-solver.h"
+
+namespace ace {
+
+// A constraint network solver running independent random walks on multiple
+// threads, each on its own copy of the network. The walk of thread i is seeded
+// with the base seed plus i, which makes the walks reproducible. The first walk
+// to find a solution cancels the others.
+class MultiWalkSolver : public Solver {
+ public:
+  static const uint32_t kDefSeed;
+
+  // Initialises the solver with the given network, number of walks and base
+  // seed.
+  MultiWalkSolver(const Network& network, const int num_walkers,
+                  const uint32_t seed);
+
+  // Deletes the walks.
+  ~MultiWalkSolver();
+
+  // Searches for a solution for the network.
+  // Returns whether it found a solution.
+  bool Solve();
+
+  // Returns false, the search can only prove satisfiability.
+  bool complete() const;
+
+  // Cancels all walks.
+  void Cancel();
+
+  // Resets the solver meta-information, which is collected during search.
+  void Reset();
+
+  // Sets the random walk parameters of all walks.
+  void max_num_tries(const int n);
+  void max_num_flips(const int n);
+  void random_probability(const int p);
+
+  // Sets whether the walks share their best assignment.
+  void share_best(const bool share);
+
+  // Sets the time limit for the search. Search will be terminated if the time
+  // limit is exceeded, returning false.
+  void time_limit(const base::Clock::Diff& limit);
+
+  // Returns the set time limit.
+  base::Clock::Diff time_limit() const;
+
+  // Sets the maximum number of solutions to be searched for.
+  void max_num_solutions(const int num);
+
+  // Returns the set maximum number of solutions to be searched for.
+  int max_num_solutions() const;
+
+  // Returns a const reference to the solutions found by the winning walk,
+  // which are also passed to the solution sink if set.
+  const std::vector<Assignment>& solutions() const;
+
+  // Returns the wall time duration of the last search in microseconds.
+  base::Clock::Diff duration() const;
+
+  // Returns the number of random steps over all walks.
+  int num_random_steps() const;
+
+  // Returns the number of greedy steps over all walks.
+  int num_greedy_steps() const;
+
+  // Returns the number of backtracks used during the last search.
+  int num_backtracks() const;
+
+  // Returns the number of states explored during the last search.
+  double num_explored_states() const;
+
+  // Returns the index of the walk which found the solution, -1 if none did.
+  int winner() const;
+
+  // Returns the number of walks.
+  int num_walkers() const;
+
+ private:
+  // Runs the given walk, executed on a separate thread.
+  void Run(const int walker_id);
+
+  std::vector<Network*> networks_;
+  std::vector<RandomWalkSolver*> walkers_;
+  std::vector<Assignment> no_solutions_;
+  SharedAssignment shared_;
+  std::mutex mutex_;
+  std::condition_variable finished_;
+  int num_running_;
+  int winner_;
+  base::Clock::Diff duration_;
+  base::Clock::Diff time_limit_;
+  int max_num_solutions_;
+};
+
+}  // namespace ace
+#endif  // SRC_MULTI_WALK_SOLVER_H_
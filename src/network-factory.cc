@@ -14,6 +14,10 @@ using ace::parse::Instance;
 
 namespace ace {
 
+NetworkFactory::NetworkFactory()
+    : duration_(0),
+      merge_constraints_(true) {}
+
 Network NetworkFactory::Create(const Instance& instance) {
   const Clock beg;
 
@@ -28,7 +32,7 @@ Network NetworkFactory::Create(const Instance& instance) {
   NameIdMap constraint_map;
   AddConstraints(instance, variable_map, relation_map,
                  &constraint_map, &network);
-  network.Finalise();
+  network.Finalise(merge_constraints_);
   // tuples_cache_.clear();
 
   duration_ = Clock() - beg;
@@ -39,6 +43,10 @@ Clock::Diff NetworkFactory::duration() const {
   return duration_;
 }
 
+void NetworkFactory::merge_constraints(const bool merge) {
+  merge_constraints_ = merge;
+}
+
 void NetworkFactory::AddDomains(const Instance& instance,
                                 NameIdMap* domain_map,
                                 Network* network) {
@@ -83,8 +91,7 @@ void NetworkFactory::AddRelations(const Instance& instance,
     Relation::Semantics semantics =
       r.semantics == ace::parse::Relation::kSupports ? Relation::kSupports :
                                                        Relation::kConflicts;
-    Relation::TupleSet tuples(r.tuples.begin(), r.tuples.end());
-    Relation relation(r.name, semantics, tuples);
+    Relation relation(r.name, semantics, r.tuples);
     (*relation_map)[r.name] = network->AddRelation(relation);
   }
   assert(relation_map->size() == relations.size());
@@ -19,9 +19,16 @@ typedef std::unordered_map<std::string, int> NameIdMap;
 
 class NetworkFactory {
  public:
+  NetworkFactory();
+
   // Creates a constraint network out of a parsed instance.
   Network Create(const parse::Instance& instance);
 
+  // Sets whether binary constraints on the same variables are merged into one
+  // constraint, which is the default. Max-CSP search counts the violated
+  // constraints and requires them to be kept apart.
+  void merge_constraints(const bool merge);
+
   // Returns the duration of the last network creation in microseconds.
   base::Clock::Diff duration() const;
 
@@ -44,6 +51,7 @@ class NetworkFactory {
 
   // TupleSetMap tuples_cache_;
   base::Clock::Diff duration_;
+  bool merge_constraints_;
 };
 
 }  // namespace ace
@@ -7,6 +7,7 @@
 #include <algorithm>
 
 using std::unordered_set;
+using std::unordered_map;
 using std::string;
 using std::vector;
 using std::set;
@@ -15,11 +16,17 @@ using std::min;
 using std::max;
 using std::pair;
 using std::make_pair;
+using std::sort;
 
 namespace ace {
 
+std::atomic<int> Network::num_networks_(0);
+
 Network::Network()
-    : num_states_(0.0) {}
+    : interchangeable_values_(false),
+      merge_constraints_(true),
+      num_states_(0.0),
+      id_(num_networks_++) {}
 
 string Network::name() const {
   return name_;
@@ -29,6 +36,10 @@ void Network::name(const string& name) {
   name_ = name;
 }
 
+int Network::id() const {
+  return id_;
+}
+
 int Network::AddDomain(const Domain& domain) {
   domains_.push_back(domain);
   return domains_.size() - 1;
@@ -50,6 +61,9 @@ int Network::AddConstraint(const Constraint& constraint) {
   const int constraint_id = constraints_.size() - 1;
   AddVarConstraints(constraint_id);
   AddScopeConstraint(constraint_id);
+  if (constraint.arity() != 2) {
+    table_constraints_.push_back(constraint_id);
+  }
   return constraint_id;
 }
 
@@ -64,12 +78,19 @@ void Network::AddVarConstraints(const int constraint_id) {
 
 void Network::AddScopeConstraint(const int constraint_id) {
   const Constraint& c = constraint(constraint_id);
+  if (c.arity() != 2) {
+    return;
+  }
   pair<int, int> key(min(c.scope(0), c.scope(1)),
                      max(c.scope(0), c.scope(1)));
   scope_constraints_[key] = constraint_id;
 }
 
-void Network::Finalise() {
+void Network::Finalise(const bool merge_constraints) {
+  merge_constraints_ = merge_constraints;
+  if (merge_constraints_) {
+    MergeConstraints();
+  }
   // Collect transitive variables on a path between two other variables on the
   // primal graph. Required for PC2.
   path_variables_.resize(num_constraints());
@@ -78,6 +99,8 @@ void Network::Finalise() {
       AddPathVariables(i);
     }
   }
+  FindAllDifferent();
+  FindValueSymmetry();
   // Calculate the number of states.
   num_states_ = 1.0;
   for (auto it = variables_.cbegin(), end = variables_.cend();
@@ -87,6 +110,233 @@ void Network::Finalise() {
   }
 }
 
+Network Network::Subnetwork(const vector<int>& variables) const {
+  Network network;
+  network.name(name_);
+  // Network, domain and relation ids are kept, they are shared by the
+  // constraint matrix cache. The constraints keep their matrices.
+  network.id_ = id_;
+  network.domains_ = domains_;
+  network.relations_ = relations_;
+  vector<int> ids(num_variables(), -1);
+  for (auto it = variables.cbegin(), end = variables.cend(); it != end; ++it) {
+    ids[*it] = network.AddVariable(variable(*it));
+  }
+  for (auto it = constraints_.cbegin(), end = constraints_.cend();
+       it != end; ++it) {
+    const vector<int>& scope = it->scope();
+    vector<int> sub_scope;
+    sub_scope.reserve(scope.size());
+    for (auto it2 = scope.cbegin(), end2 = scope.cend();
+         it2 != end2 && ids[*it2] != -1; ++it2) {
+      sub_scope.push_back(ids[*it2]);
+    }
+    if (sub_scope.size() == scope.size()) {
+      network.AddConstraint(Constraint(*it, sub_scope));
+    }
+  }
+  network.Finalise(merge_constraints_);
+  return network;
+}
+
+void Network::MergeConstraints() {
+  // Map each binary constraint to the first constraint on the same variables.
+  const int num_cons = num_constraints();
+  unordered_map<pair<int, int>, int, PairHash> scope_ids;
+  vector<int> targets(num_cons, -1);
+  int num_merged = 0;
+  for (int i = 0; i < num_cons; ++i) {
+    const Constraint& c = constraints_[i];
+    if (c.arity() != 2) {
+      continue;
+    }
+    pair<int, int> key(min(c.scope(0), c.scope(1)),
+                       max(c.scope(0), c.scope(1)));
+    auto inserted = scope_ids.insert(make_pair(key, i));
+    if (!inserted.second) {
+      targets[i] = inserted.first->second;
+      ++num_merged;
+    }
+  }
+  if (!num_merged) {
+    return;
+  }
+  // Conjoin the parallel constraints and rebuild the constraint indices.
+  vector<Constraint> constraints;
+  constraints.reserve(num_cons - num_merged);
+  vector<int> ids(num_cons, -1);
+  for (int i = 0; i < num_cons; ++i) {
+    if (targets[i] == -1) {
+      ids[i] = constraints.size();
+      constraints.push_back(constraints_[i]);
+    } else {
+      constraints[ids[targets[i]]].Conjoin(constraints_[i]);
+    }
+  }
+  constraints_.swap(constraints);
+  var_constraints_.assign(num_variables(), vector<int>());
+  scope_constraints_.clear();
+  table_constraints_.clear();
+  for (int i = 0; i < num_constraints(); ++i) {
+    AddVarConstraints(i);
+    AddScopeConstraint(i);
+    if (constraints_[i].arity() != 2) {
+      table_constraints_.push_back(i);
+    }
+  }
+}
+
+// Orders variables by decreasing degree in the not-equal graph.
+struct DegreeGreater {
+  explicit DegreeGreater(const vector<set<int> >& graph)
+      : graph(graph) {}
+
+  bool operator()(const int lhs, const int rhs) const {
+    return graph[lhs].size() > graph[rhs].size() ||
+           (graph[lhs].size() == graph[rhs].size() && lhs < rhs);
+  }
+
+  const vector<set<int> >& graph;
+};
+
+void Network::FindAllDifferent() {
+  // Collect the not-equal graph of the binary constraints which forbid all
+  // pairs of equal values.
+  const int num_vars = num_variables();
+  not_equal_graph_.assign(num_vars, set<int>());
+  vector<set<int> >& graph = not_equal_graph_;
+  vector<int> values(2, 0);
+  for (auto it = constraints_.cbegin(), end = constraints_.cend();
+       it != end; ++it) {
+    const Constraint& c = *it;
+    if (c.arity() != 2 || c.scope(0) == c.scope(1)) {
+      continue;
+    }
+    const Variable& var1 = variable(c.scope(0));
+    const Variable& var2 = variable(c.scope(1));
+    unordered_map<int, int> value_ids;
+    for (int v = 0; v < var2.num_values(); ++v) {
+      value_ids[var2.value(v)] = v;
+    }
+    bool not_equal = true;
+    for (int v = 0; v < var1.num_values() && not_equal; ++v) {
+      auto equal = value_ids.find(var1.value(v));
+      if (equal != value_ids.end()) {
+        values[0] = v;
+        values[1] = equal->second;
+        not_equal = !c.Supports(values);
+      }
+    }
+    if (not_equal) {
+      graph[c.scope(0)].insert(c.scope(1));
+      graph[c.scope(1)].insert(c.scope(0));
+    }
+  }
+
+  // Cover the not-equal edges greedily by cliques, preferring the uncovered
+  // edges and high degree variables.
+  all_different_.clear();
+  vector<int> vars(num_vars, 0);
+  for (int i = 0; i < num_vars; ++i) {
+    vars[i] = i;
+  }
+  sort(vars.begin(), vars.end(), DegreeGreater(graph));
+  vector<set<int> > covered(num_vars);
+  for (auto it = vars.cbegin(), end = vars.cend(); it != end; ++it) {
+    const int var_id = *it;
+    while (covered[var_id].size() < graph[var_id].size()) {
+      vector<int> uncovered;
+      vector<int> candidates;
+      for (auto it2 = graph[var_id].cbegin(), end2 = graph[var_id].cend();
+           it2 != end2; ++it2) {
+        if (covered[var_id].count(*it2)) {
+          candidates.push_back(*it2);
+        } else {
+          uncovered.push_back(*it2);
+        }
+      }
+      sort(uncovered.begin(), uncovered.end(), DegreeGreater(graph));
+      sort(candidates.begin(), candidates.end(), DegreeGreater(graph));
+      candidates.insert(candidates.begin(), uncovered.begin(),
+                        uncovered.end());
+      vector<int> clique(1, var_id);
+      for (auto it2 = candidates.cbegin(), end2 = candidates.cend();
+           it2 != end2; ++it2) {
+        const set<int>& neighs = graph[*it2];
+        bool adjacent = true;
+        for (auto it3 = clique.cbegin(), end3 = clique.cend();
+             it3 != end3 && adjacent; ++it3) {
+          adjacent = neighs.count(*it3);
+        }
+        if (adjacent) {
+          clique.push_back(*it2);
+        }
+      }
+      for (auto it2 = clique.cbegin(), end2 = clique.cend();
+           it2 != end2; ++it2) {
+        covered[*it2].insert(clique.begin(), clique.end());
+        covered[*it2].erase(*it2);
+      }
+      if (clique.size() > 2) {
+        sort(clique.begin(), clique.end());
+        all_different_.push_back(clique);
+      }
+    }
+  }
+}
+
+void Network::FindValueSymmetry() {
+  interchangeable_values_ = false;
+  if (variables_.empty()) {
+    return;
+  }
+  // All variables need to share the same domain values.
+  const Variable& first = variables_.front();
+  const int num_values = first.num_values();
+  for (auto it = variables_.cbegin(), end = variables_.cend();
+       it != end; ++it) {
+    if (it->num_values() != num_values) {
+      return;
+    }
+    for (int v = 0; v < num_values; ++v) {
+      if (it->value(v) != first.value(v)) {
+        return;
+      }
+    }
+  }
+  // A binary relation is invariant under all value permutations, iff it only
+  // distinguishes equal from different values. Constraints sharing a relation
+  // share the same matrix, which is checked only once.
+  unordered_set<int> checked;
+  vector<int> values(2, 0);
+  for (auto it = constraints_.cbegin(), end = constraints_.cend();
+       it != end; ++it) {
+    const Constraint& c = *it;
+    if (c.arity() != 2) {
+      return;
+    }
+    if (c.relation_id() != -1 && !checked.insert(c.relation_id()).second) {
+      continue;
+    }
+    values[0] = 0;
+    values[1] = 0;
+    const bool equal_support = c.Supports(values);
+    values[1] = 1;
+    const bool different_support = num_values > 1 && c.Supports(values);
+    for (int v1 = 0; v1 < num_values; ++v1) {
+      values[0] = v1;
+      for (int v2 = 0; v2 < num_values; ++v2) {
+        values[1] = v2;
+        if (c.Supports(values) != (v1 == v2 ? equal_support :
+                                              different_support)) {
+          return;
+        }
+      }
+    }
+  }
+  interchangeable_values_ = true;
+}
+
 void Network::AddPathVariables(const int constraint_id) {
   const Constraint& con = constraint(constraint_id);
   assert(con.arity() == 2);
@@ -130,6 +380,10 @@ void Network::StartTransaction() {
     Variable& var = *it;
     var.StartTransaction();
   }
+  for (auto it = table_constraints_.cbegin(), end = table_constraints_.cend();
+       it != end; ++it) {
+    constraints_[*it].StartTransaction();
+  }
 }
 
 void Network::CommitTransaction() {
@@ -137,6 +391,10 @@ void Network::CommitTransaction() {
     Variable& var = *it;
     var.CommitTransaction();
   }
+  for (auto it = table_constraints_.cbegin(), end = table_constraints_.cend();
+       it != end; ++it) {
+    constraints_[*it].CommitTransaction();
+  }
 }
 
 void Network::RollbackTransaction() {
@@ -144,6 +402,10 @@ void Network::RollbackTransaction() {
     Variable& var = *it;
     var.RollbackTransaction();
   }
+  for (auto it = table_constraints_.cbegin(), end = table_constraints_.cend();
+       it != end; ++it) {
+    constraints_[*it].RollbackTransaction();
+  }
 }
 
 const Domain& Network::domain(const int id) const {
@@ -195,11 +457,27 @@ const vector<Constraint>& Network::constraints() const {
   return constraints_;
 }
 
+const vector<int>& Network::table_constraints() const {
+  return table_constraints_;
+}
+
 const vector<int>& Network::constraints(const int variable) const {
   assert(variable >= 0 && variable < static_cast<int>(variables_.size()));
   return var_constraints_[variable];
 }
 
+const vector<vector<int> >& Network::all_different() const {
+  return all_different_;
+}
+
+const vector<set<int> >& Network::not_equal_graph() const {
+  return not_equal_graph_;
+}
+
+bool Network::interchangeable_values() const {
+  return interchangeable_values_;
+}
+
 const vector<int>& Network::path_variables(const int constraint_id) const {
   assert(constraint_id >= 0 && constraint_id < num_constraints());
   return path_variables_[constraint_id];
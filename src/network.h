@@ -2,9 +2,11 @@
 #ifndef SRC_NETWORK_H_
 #define SRC_NETWORK_H_
 
+#include <atomic>
 #include <unordered_map>
 #include <utility>
 #include <string>
+#include <set>
 #include <vector>
 #include "./domain.h"
 #include "./relation.h"
@@ -27,7 +29,16 @@ class Network {
   int AddVariable(const Variable& variable);
   int AddRelation(const Relation& relation);
   int AddConstraint(const Constraint& constraint);
-  void Finalise();
+
+  // Finalises the network after all constraints are added. Binary constraints
+  // on the same variables are merged into one when requested.
+  void Finalise(const bool merge_constraints);
+
+  // Returns the finalised network induced by the given variables, which are
+  // renumbered by their position. The variables keep their current domains,
+  // constraints on other variables are dropped. Binary constraints on the
+  // same variables are merged if they are merged in this network.
+  Network Subnetwork(const std::vector<int>& variables) const;
 
   void StartTransaction();
   void CommitTransaction();
@@ -42,10 +53,30 @@ class Network {
   const Constraint& constraint(const int id) const;
   Constraint& constraint(const int id);
   const std::vector<int>& path_variables(const int constraint_id) const;
+
+  // Returns the scopes of the all-different constraints implied by cliques of
+  // binary constraints forbidding equal values, collected by Finalise.
+  const std::vector<std::vector<int> >& all_different() const;
+
+  // Returns the neighbours of each variable in the graph of the binary
+  // constraints forbidding equal values, collected by Finalise.
+  const std::vector<std::set<int> >& not_equal_graph() const;
+
+  // Returns the ids of the non-binary constraints, which are propagated by
+  // their tables.
+  const std::vector<int>& table_constraints() const;
+
+  // Returns whether all values are fully interchangeable, i.e. every
+  // permutation of the common domain maps solutions to solutions.
+  bool interchangeable_values() const;
   const std::vector<int>& constraints(const int variable) const;
   const std::vector<Constraint>& constraints() const;
   std::string name() const;
   void name(const std::string& name);
+
+  // Returns the id of the network, which is shared by its copies and
+  // subnetworks.
+  int id() const;
   int num_variables() const;
   int num_constraints() const;
   double num_states() const;
@@ -57,16 +88,27 @@ class Network {
   void AddVarConstraints(const int constraint_id);
   void AddScopeConstraint(const int constraint_id);
   void AddPathVariables(const int constraint_id);
+  void MergeConstraints();
+  void FindAllDifferent();
+  void FindValueSymmetry();
+
+  static std::atomic<int> num_networks_;
 
   std::vector<Domain> domains_;
   std::vector<Variable> variables_;
   std::vector<Relation> relations_;
   std::vector<Constraint> constraints_;
   std::vector<std::vector<int> > var_constraints_;
+  std::vector<int> table_constraints_;
   std::unordered_map<std::pair<int, int>, int, PairHash> scope_constraints_;
   std::vector<std::vector<int> > path_variables_;
+  std::vector<std::set<int> > not_equal_graph_;
+  std::vector<std::vector<int> > all_different_;
+  bool interchangeable_values_;
+  bool merge_constraints_;
   double num_states_;
   std::string name_;
+  int id_;
 };
 
 }  // namespace ace
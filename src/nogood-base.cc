@@ -0,0 +1,151 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include "./nogood-base.h"
+#include <cassert>
+#include <vector>
+#include <algorithm>
+#include "./network.h"
+#include "./assignment.h"
+
+using std::vector;
+using std::swap;
+
+namespace ace {
+
+const int NogoodBase::kDefMaxNumLiterals = 1 << 22;
+
+NogoodBase::NogoodBase(Network* network)
+    : network_(network),
+      max_num_literals_(kDefMaxNumLiterals) {
+  const int num_variables = network_->num_variables();
+  watches_.resize(num_variables);
+  for (int v = 0; v < num_variables; ++v) {
+    watches_[v].resize(network_->variable(v).num_values());
+  }
+  Clear();
+  Reset();
+}
+
+bool NogoodBase::Add(const vector<Literal>& literals) {
+  assert(literals.size());
+  if (literals.size() == 1) {
+    // Unary nogoods are applied to the domain directly.
+    const Literal& literal = literals.front();
+    network_->variable(literal.variable).RemoveValue(literal.value);
+    return true;
+  }
+  const int size = literals.size();
+  if (max_num_literals_ && num_literals_ + size > max_num_literals_) {
+    // Memory cap reached.
+    return false;
+  }
+  const int nogood_id = nogoods_.size();
+  // The literals are given in decision order, the last decisions are watched,
+  // since they are the last to be satisfied when following the same branch.
+  nogoods_.push_back(vector<Literal>(literals.rbegin(), literals.rend()));
+  const vector<Literal>& nogood = nogoods_.back();
+  watches_[nogood[0].variable][nogood[0].value].push_back(nogood_id);
+  watches_[nogood[1].variable][nogood[1].value].push_back(nogood_id);
+  num_literals_ += size;
+  return true;
+}
+
+bool NogoodBase::Propagate(const int variable, const int value,
+                           const Assignment& assignment,
+                           vector<int>* reduced) {
+  assert(reduced);
+  vector<int>& watching = watches_[variable][value];
+  size_t i = 0;
+  while (i < watching.size()) {
+    const int nogood_id = watching[i];
+    vector<Literal>& nogood = nogoods_[nogood_id];
+    // Keep the satisfied literal at the second watch position.
+    if (nogood[0].variable == variable) {
+      swap(nogood[0], nogood[1]);
+    }
+    assert(nogood[1].variable == variable && nogood[1].value == value);
+    const Literal& other = nogood[0];
+    if (False(other, assignment)) {
+      // The nogood can not be completed anymore.
+      ++i;
+      continue;
+    }
+    // Search for a replacement watch.
+    const int size = nogood.size();
+    int k = 2;
+    while (k < size && True(nogood[k], assignment)) {
+      ++k;
+    }
+    if (k < size) {
+      swap(nogood[1], nogood[k]);
+      watches_[nogood[1].variable][nogood[1].value].push_back(nogood_id);
+      watching[i] = watching.back();
+      watching.pop_back();
+      continue;
+    }
+    // All literals but the other watched one are satisfied.
+    if (True(other, assignment)) {
+      return false;
+    }
+    Variable& var = network_->variable(other.variable);
+    var.RemoveValue(other.value);
+    ++num_prunings_;
+    reduced->push_back(other.variable);
+    if (var.domain().empty()) {
+      return false;
+    }
+    ++i;
+  }
+  return true;
+}
+
+bool NogoodBase::True(const Literal& literal,
+                      const Assignment& assignment) const {
+  return assignment.Assigned(literal.variable) &&
+         assignment.value(literal.variable) == literal.value;
+}
+
+bool NogoodBase::False(const Literal& literal,
+                       const Assignment& assignment) const {
+  if (assignment.Assigned(literal.variable)) {
+    return assignment.value(literal.variable) != literal.value;
+  }
+  return !network_->variable(literal.variable).valid(literal.value);
+}
+
+void NogoodBase::Clear() {
+  nogoods_.clear();
+  for (auto it = watches_.begin(), end = watches_.end(); it != end; ++it) {
+    vector<vector<int> >& var_watches = *it;
+    for (auto it2 = var_watches.begin(), end2 = var_watches.end();
+         it2 != end2; ++it2) {
+      it2->clear();
+    }
+  }
+  num_literals_ = 0;
+}
+
+void NogoodBase::Reset() {
+  num_prunings_ = 0;
+}
+
+void NogoodBase::max_num_literals(const int num) {
+  max_num_literals_ = num > 0 ? num : 0;
+}
+
+int NogoodBase::max_num_literals() const {
+  return max_num_literals_;
+}
+
+int NogoodBase::num_nogoods() const {
+  return nogoods_.size();
+}
+
+int NogoodBase::num_literals() const {
+  return num_literals_;
+}
+
+int NogoodBase::num_prunings() const {
+  return num_prunings_;
+}
+
+}  // namespace ace
@@ -0,0 +1,81 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#ifndef SRC_NOGOOD_BASE_H_
+#define SRC_NOGOOD_BASE_H_
+
+#include <vector>
+
+namespace ace {
+
+class Network;
+class Assignment;
+
+// A base of nogoods, which are sets of positive decisions (variable = value)
+// that can not be extended to a solution. Nogoods are propagated using two
+// watched literals, unary nogoods are applied to the domains directly.
+class NogoodBase {
+ public:
+  static const int kDefMaxNumLiterals;
+
+  // A nogood literal, representing the decision variable = value (by id).
+  struct Literal {
+    Literal(const int variable, const int value)
+        : variable(variable),
+          value(value) {}
+    int variable;
+    int value;
+  };
+
+  // Initialises the empty nogood base for given network.
+  explicit NogoodBase(Network* network);
+
+  // Adds a nogood given by its literals. Unary nogoods are not stored, their
+  // value is removed from the domain instead.
+  // Returns false if the nogood was dropped because of the memory cap.
+  bool Add(const std::vector<Literal>& literals);
+
+  // Propagates the decision variable = value for given assignment. Removes all
+  // values which would complete a nogood and collects the variables of the
+  // reduced domains.
+  // Returns false if a nogood is violated or a domain becomes empty.
+  bool Propagate(const int variable, const int value,
+                 const Assignment& assignment, std::vector<int>* reduced);
+
+  // Removes all stored nogoods.
+  void Clear();
+
+  // Resets the statistics collected during propagation.
+  void Reset();
+
+  // Sets the maximum number of stored literals (0 for unlimited).
+  void max_num_literals(const int num);
+
+  // Returns the maximum number of stored literals.
+  int max_num_literals() const;
+
+  // Returns the number of stored nogoods.
+  int num_nogoods() const;
+
+  // Returns the number of stored literals over all nogoods.
+  int num_literals() const;
+
+  // Returns the number of domain values pruned by nogoods since last reset.
+  int num_prunings() const;
+
+ private:
+  // Returns whether the literal is satisfied by given assignment.
+  bool True(const Literal& literal, const Assignment& assignment) const;
+
+  // Returns whether the literal can not be satisfied anymore.
+  bool False(const Literal& literal, const Assignment& assignment) const;
+
+  Network* network_;
+  std::vector<std::vector<Literal> > nogoods_;
+  // The ids of the nogoods watching a literal, indexed by variable and value.
+  std::vector<std::vector<std::vector<int> > > watches_;
+  int num_literals_;
+  int max_num_literals_;
+  int num_prunings_;
+};
+
+}  // namespace ace
+#endif  // SRC_NOGOOD_BASE_H_
@@ -0,0 +1,280 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include "./parallel-backtrack-solver.h"
+#include <cassert>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include "./clock.h"
+#include "./network.h"
+#include "./variable-ordering.h"
+
+using std::vector;
+using std::thread;
+using std::mutex;
+using std::lock_guard;
+using std::min;
+using std::max;
+using base::Clock;
+
+namespace ace {
+
+ParallelBacktrackSolver::Worker::Worker(const Network& root)
+    : network(root),
+      preprocessor(&network),
+      assignment(network),
+      num_explored_states(0.0),
+      num_backtracks(0),
+      num_steals(0) {}
+
+ParallelBacktrackSolver::ParallelBacktrackSolver(const Network& network,
+                                                 const int num_workers)
+    : Solver(),
+      network_(network),
+      num_open_nodes_(0),
+      done_(false),
+      begin_clock_(Clock::kWallTime),
+      time_limit_(Solver::kDefTimeLimit),
+      max_num_solutions_(Solver::kDefMaxNumSolutions) {
+  assert(num_workers > 0);
+  for (int w = 0; w < num_workers; ++w) {
+    workers_.push_back(new Worker(network_));
+  }
+  Reset();
+  // Set the lexicographical variable ordering.
+  const int num_vars = network_.num_variables();
+  var_ordering_.resize(num_vars, 0);
+  for (int i = 0; i < num_vars; ++i) {
+    var_ordering_[i] = i;
+  }
+}
+
+ParallelBacktrackSolver::~ParallelBacktrackSolver() {
+  for (auto it = workers_.begin(), end = workers_.end(); it != end; ++it) {
+    delete *it;
+  }
+}
+
+bool ParallelBacktrackSolver::Solve() {
+  Reset();
+  begin_clock_ = Clock(Clock::kWallTime);
+  solutions_.clear();
+  num_solutions_ = 0;
+  // Move all workers back to the root.
+  for (auto it = workers_.begin(), end = workers_.end(); it != end; ++it) {
+    Worker* worker = *it;
+    while (worker->assignment.num_assigned()) {
+      worker->network.RollbackTransaction();
+      worker->assignment.Revert();
+    }
+  }
+  done_ = false;
+  num_open_nodes_ = 1;
+  workers_.front()->deque.Push(new Node());
+
+  const int num_workers = workers_.size();
+  vector<thread> threads;
+  threads.reserve(num_workers);
+  for (int w = 0; w < num_workers; ++w) {
+    threads.push_back(thread(&ParallelBacktrackSolver::Run, this, w));
+  }
+  for (auto it = threads.begin(), end = threads.end(); it != end; ++it) {
+    it->join();
+  }
+  // Release the nodes left after termination.
+  for (auto it = workers_.begin(), end = workers_.end(); it != end; ++it) {
+    Node* node = nullptr;
+    while ((*it)->deque.Pop(&node)) {
+      delete node;
+    }
+  }
+  duration_ = Clock(Clock::kWallTime) - begin_clock_;
+  return num_solutions_;
+}
+
+void ParallelBacktrackSolver::Run(const int worker_id) {
+  Worker* worker = workers_[worker_id];
+  while (!done_) {
+    if (cancelled_ || Clock(Clock::kWallTime) - begin_clock_ > time_limit_) {
+      // Time limit reached or search cancelled.
+      done_ = true;
+      break;
+    }
+    Node* node = Take(worker_id);
+    if (!node) {
+      if (num_open_nodes_ == 0) {
+        // The search tree is exhausted.
+        break;
+      }
+      std::this_thread::yield();
+      continue;
+    }
+    Expand(*node, worker);
+    delete node;
+    if (--num_open_nodes_ == 0) {
+      done_ = true;
+    }
+  }
+}
+
+ParallelBacktrackSolver::Node* ParallelBacktrackSolver::Take(
+    const int worker_id) {
+  Worker* worker = workers_[worker_id];
+  Node* node = nullptr;
+  if (worker->deque.Pop(&node)) {
+    return node;
+  }
+  // Steal the shallowest open node of another worker.
+  const int num_workers = workers_.size();
+  for (int i = 1; i < num_workers; ++i) {
+    Worker* victim = workers_[(worker_id + i) % num_workers];
+    if (victim->deque.Steal(&node)) {
+      ++worker->num_steals;
+      return node;
+    }
+  }
+  return nullptr;
+}
+
+void ParallelBacktrackSolver::Expand(const Node& node, Worker* worker) {
+  if (!MoveTo(node, worker)) {
+    return;
+  }
+  Assignment& assignment = worker->assignment;
+  if (assignment.Complete()) {
+    // Solution found.
+    assert(assignment.Consistent());
+    AddSolution(assignment);
+    return;
+  }
+  // Select the next variable according to the ordering.
+  const int var_id = var_ordering_[assignment.num_assigned()];
+  const vector<int> domain = worker->network.variable(var_id).valid_value_ids();
+  num_open_nodes_ += domain.size();
+  // Push the children in reverse order of exploration, the owner pops the
+  // last pushed child first.
+  for (auto it = domain.cbegin(), end = domain.cend(); it != end; ++it) {
+    Node* child = new Node(node);
+    child->push_back(*it);
+    worker->deque.Push(child);
+  }
+}
+
+bool ParallelBacktrackSolver::MoveTo(const Node& node, Worker* worker) {
+  Network& network = worker->network;
+  Assignment& assignment = worker->assignment;
+  // Find the decisions shared with the current state.
+  const int depth = min<int>(assignment.num_assigned(), node.size());
+  int shared = 0;
+  while (shared < depth &&
+         assignment.value(var_ordering_[shared]) == node[shared]) {
+    ++shared;
+  }
+  // Rollback the decisions which are not shared.
+  while (assignment.num_assigned() > shared) {
+    network.RollbackTransaction();
+    assignment.Revert();
+  }
+  // Apply the missing decisions.
+  const int size = node.size();
+  for (int i = shared; i < size; ++i) {
+    const int var_id = var_ordering_[i];
+    const int value = node[i];
+    ++worker->num_explored_states;
+    assignment.Assign(var_id, value);
+    if (!assignment.Consistent()) {
+      assignment.Revert();
+      return false;
+    }
+    // Start a transaction to track all domain changes.
+    network.StartTransaction();
+    // Reduce the domain of the selected variable for the consistency test.
+    network.variable(var_id).ReduceDomain(value);
+    if (!worker->preprocessor.Propagate(var_id)) {
+      // Rollback all tracked domain changes.
+      network.RollbackTransaction();
+      assignment.Revert();
+      ++worker->num_backtracks;
+      return false;
+    }
+  }
+  return true;
+}
+
+void ParallelBacktrackSolver::AddSolution(const Assignment& assignment) {
+  lock_guard<mutex> lock(solutions_mutex_);
+  if (num_solutions_ < max_num_solutions_) {
+    Solver::AddSolution(assignment, &solutions_);
+  }
+  if (num_solutions_ >= max_num_solutions_) {
+    done_ = true;
+  }
+}
+
+void ParallelBacktrackSolver::Reset() {
+  duration_ = 0;
+  for (auto it = workers_.begin(), end = workers_.end(); it != end; ++it) {
+    Worker* worker = *it;
+    worker->num_explored_states = 0.0;
+    worker->num_backtracks = 0;
+    worker->num_steals = 0;
+  }
+}
+
+void ParallelBacktrackSolver::variable_ordering(
+    const VariableOrdering& var_ordering) {
+  var_ordering_ = var_ordering.CreateOrdering();
+}
+
+void ParallelBacktrackSolver::time_limit(const Clock::Diff& limit) {
+  time_limit_ = min(limit, Solver::kDefTimeLimit);
+}
+
+Clock::Diff ParallelBacktrackSolver::time_limit() const {
+  return time_limit_;
+}
+
+void ParallelBacktrackSolver::max_num_solutions(const int num) {
+  max_num_solutions_ = num > 0 ? num : Solver::kDefMaxNumSolutions;
+}
+
+int ParallelBacktrackSolver::max_num_solutions() const {
+  return max_num_solutions_;
+}
+
+const vector<Assignment>& ParallelBacktrackSolver::solutions() const {
+  return solutions_;
+}
+
+double ParallelBacktrackSolver::num_explored_states() const {
+  double num_explored_states = 0.0;
+  for (auto it = workers_.cbegin(), end = workers_.cend(); it != end; ++it) {
+    num_explored_states += (*it)->num_explored_states;
+  }
+  return num_explored_states;
+}
+
+int ParallelBacktrackSolver::num_backtracks() const {
+  int num_backtracks = 0;
+  for (auto it = workers_.cbegin(), end = workers_.cend(); it != end; ++it) {
+    num_backtracks += (*it)->num_backtracks;
+  }
+  return num_backtracks;
+}
+
+int ParallelBacktrackSolver::num_steals() const {
+  int num_steals = 0;
+  for (auto it = workers_.cbegin(), end = workers_.cend(); it != end; ++it) {
+    num_steals += (*it)->num_steals;
+  }
+  return num_steals;
+}
+
+int ParallelBacktrackSolver::num_workers() const {
+  return workers_.size();
+}
+
+Clock::Diff ParallelBacktrackSolver::duration() const {
+  return duration_;
+}
+
+}  // namespace ace
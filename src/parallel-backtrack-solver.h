@@ -0,0 +1,125 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#ifndef SRC_PARALLEL_BACKTRACK_SOLVER_H_
+#define SRC_PARALLEL_BACKTRACK_SOLVER_H_
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include "./solver.h"
+#include "./clock.h"
+#include "./assignment.h"
+#include "./network.h"
+#include "./ac3.h"
+#include "./work-deque.h"
+
+namespace ace {
+
+// The variable ordering.
+class VariableOrdering;
+
+// A constraint network solver based on backtracking with arc-consistency
+// look-ahead, which explores the search tree with multiple workers. Each worker
+// owns a private copy of the network and steals the shallowest unexplored
+// sibling branches from the other workers when running out of work. The search
+// is deterministic with a single worker.
+class ParallelBacktrackSolver : public Solver {
+ public:
+  // Initialises the solver with the given network and number of workers.
+  ParallelBacktrackSolver(const Network& network, const int num_workers);
+
+  // Deletes the workers.
+  ~ParallelBacktrackSolver();
+
+  // Searches for a solution for the network.
+  // Returns whether it found a solution.
+  bool Solve();
+
+  // Resets the solver meta-information, which is collected during search.
+  void Reset();
+
+  // Sets the variable ordering.
+  void variable_ordering(const VariableOrdering& var_ordering);
+
+  // Sets the time limit for the search, measured in wall time. Search will be
+  // terminated if the time limit is exceeded, returning false.
+  void time_limit(const base::Clock::Diff& limit);
+
+  // Returns the set time limit.
+  base::Clock::Diff time_limit() const;
+
+  // Sets the maximum number of solutions to be searched for.
+  void max_num_solutions(const int num);
+
+  // Returns the set maximum number of solutions to be searched for.
+  int max_num_solutions() const;
+
+  // Returns a const reference to the solutions found by the last search.
+  const std::vector<Assignment>& solutions() const;
+
+  // Returns the wall time duration of the last search in microseconds.
+  base::Clock::Diff duration() const;
+
+  // Returns the number of dead ends over all workers during the last search.
+  int num_backtracks() const;
+
+  // Returns the number of states explored during the last search.
+  double num_explored_states() const;
+
+  // Returns the number of successful steals during the last search.
+  int num_steals() const;
+
+  // Returns the number of workers.
+  int num_workers() const;
+
+ private:
+  // A search node, given by the values (by id) of the decisions along the
+  // variable ordering.
+  typedef std::vector<int> Node;
+
+  // A search worker with private domain state.
+  struct Worker {
+    explicit Worker(const Network& network);
+
+    Network network;
+    Ac3 preprocessor;
+    Assignment assignment;
+    base::WorkDeque<Node*> deque;
+    double num_explored_states;
+    int num_backtracks;
+    int num_steals;
+  };
+
+  // The search loop of given worker, executed on a separate thread.
+  void Run(const int worker_id);
+
+  // Takes the next node from the own deque or steals one from another worker.
+  // Returns nullptr if no work is available.
+  Node* Take(const int worker_id);
+
+  // Moves the worker to given node and expands it.
+  void Expand(const Node& node, Worker* worker);
+
+  // Moves the worker state to the node, rolling back decisions not shared
+  // with the current state and applying the missing ones.
+  // Returns whether the node is consistent.
+  bool MoveTo(const Node& node, Worker* worker);
+
+  // Records a solution found by the worker.
+  void AddSolution(const Assignment& assignment);
+
+  const Network& network_;
+  std::vector<Worker*> workers_;
+  std::vector<int> var_ordering_;
+  std::vector<Assignment> solutions_;
+  std::mutex solutions_mutex_;
+  // The number of nodes pushed, but not yet expanded.
+  std::atomic<int64_t> num_open_nodes_;
+  std::atomic<bool> done_;
+  base::Clock begin_clock_;
+  base::Clock::Diff duration_;
+  base::Clock::Diff time_limit_;
+  size_t max_num_solutions_;
+};
+
+}  // namespace ace
+#endif  // SRC_PARALLEL_BACKTRACK_SOLVER_H_
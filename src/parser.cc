@@ -1,12 +1,16 @@
 // Copyright 2012 Eugen Sawin <esawin@me73.com>
 #include "./parser.h"
 #include <cassert>
+#include <cctype>
+#include <cstdlib>
 #include <fstream>
+#include <iostream>
 #include <sstream>
 
 using std::string;
 using std::ifstream;
 using std::stringstream;
+using std::cout;
 using std::vector;
 using std::set;
 using std::min;
@@ -37,17 +41,27 @@ string Relation::Str() const {
   stringstream ss;
   ss << "(" << name << " " << arity << (semantics == kSupports ? " s " : " c ")
      << "(";
-  for (auto it = tuples.begin(); it != tuples.end(); ++it) {
+  // The tuples are listed in lexicographical order.
+  set<vector<int>, VectorLess> ordered;
+  for (size_t i = 0, size = tuples.size(); i < size; ++i) {
+    const int* tuple = tuples.tuple(i);
+    ordered.insert(vector<int>(tuple, tuple + tuples.arity()));
+  }
+  for (auto it = ordered.cbegin(), end = ordered.cend(); it != end; ++it) {
     const vector<int>& tuple = *it;
-    if (it != tuples.begin()) {
+    if (it != ordered.cbegin()) {
       ss << " ";
     }
     ss << "(";
-    for (auto it2 = tuple.begin(); it2 != tuple.end(); ++it2) {
-      if (it2 != tuple.begin()) {
+    for (auto it2 = tuple.cbegin(), end2 = tuple.cend(); it2 != end2; ++it2) {
+      if (it2 != tuple.cbegin()) {
         ss << " ";
       }
-      ss << *it2;
+      if (*it2 == TupleTable::kAny) {
+        ss << "*";
+      } else {
+        ss << *it2;
+      }
     }
     ss << ")";
   }
@@ -168,43 +182,42 @@ void Parser::CollectIntValues(set<int>* values, const string& content) {
   }
 }
 
-void Parser::CollectIntTuples(Relation::TupleSet* tuples,
+bool Parser::CollectIntTuples(Relation::TupleSet* tuples,
                               const string& content) {
   assert(tuples);
-  size_t pos = content.find_first_of(kNumbers);
-  while (pos != string::npos) {
-    pos = content.find_first_of(kNumbers, pos);
-    assert(pos != string::npos);
-    size_t value_end = content.find_first_of("|", pos);
-    if (value_end == string::npos) {
-      // Last tuple found.
-      vector<int> tuple;
-      stringstream ss;
-      ss << content.substr(pos);
-      while (ss.good()) {
-        int value = 0;
-        ss >> value;
-        if (!ss.fail()) {
-          tuple.push_back(value);
-        }
-      }
-      tuples->insert(tuple);
-    } else {
-      // Tuple found.
-      vector<int> tuple;
-      stringstream ss;
-      ss << content.substr(pos, value_end - pos);
-      while (ss.good()) {
-        int value = 0;
-        ss >> value;
-        if (!ss.fail()) {
-          tuple.push_back(value);
-        }
+  vector<int> tuple;
+  const char* c = content.c_str();
+  while (*c) {
+    tuple.clear();
+    bool wildcards = false;
+    while (*c && *c != '|') {
+      if (*c == '*') {
+        // Wildcard found.
+        tuple.push_back(TupleTable::kAny);
+        wildcards = true;
+        ++c;
+      } else if (isdigit(*c) || (*c == '-' && isdigit(c[1]))) {
+        // Value found.
+        char* value_end = nullptr;
+        tuple.push_back(strtol(c, &value_end, 10));
+        c = value_end;
+      } else {
+        ++c;
       }
-      tuples->insert(tuple);
     }
-    pos = value_end;
+    if (wildcards &&
+        static_cast<int>(tuple.size()) > TupleTable::kMaxWildcardArity) {
+      return false;
+    }
+    if (tuple.size()) {
+      tuples->Insert(tuple);
+    }
+    if (*c) {
+      // Skip the tuple separator.
+      ++c;
+    }
   }
+  return true;
 }
 
 vector<int> Parser::CollectInts(const string& content, const string& delims) {
@@ -397,7 +410,14 @@ size_t Parser::LoadRelation(Relation* relation, const size_t pos) const {
   size_t num_tuples = 0;
   LoadAttribute("nbTuples", &num_tuples, relation_beg, relation_end);
   string content_str = Content(relation_beg, relation_end);
-  CollectIntTuples(&relation->tuples, content_str);
+  relation->tuples = Relation::TupleSet(relation->arity);
+  relation->tuples.Reserve(num_tuples);
+  if (!CollectIntTuples(&relation->tuples, content_str)) {
+    cout << "Relation " << relation->name << " has wildcard tuples of arity "
+         << relation->arity << ", wildcards are supported up to arity "
+         << TupleTable::kMaxWildcardArity << ".\n";
+    exit(1);
+  }
   assert(relation->tuples.size() == num_tuples);
   return relation_end;
 }
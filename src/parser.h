@@ -7,6 +7,7 @@
 #include <set>
 #include <string>
 #include "./clock.h"
+#include "./tuple-table.h"
 
 namespace ace { namespace parse {
 
@@ -38,7 +39,7 @@ struct Relation {
                     const std::vector<int>& rhs) const;
   };
 
-  typedef std::set<std::vector<int>, VectorLess> TupleSet;
+  typedef TupleTable TupleSet;
 
   // Returns a string representation.
   std::string Str() const;
@@ -121,7 +122,10 @@ class Parser {
 
   // Collects int tuples, which are int sequences separated by | from given
   // string. E.g.: 1 3 | 1 4 | 2 4 --> {[1, 3], [1, 4], [2, 4]}.
-  static void CollectIntTuples(Relation::TupleSet* tuples,
+  // The wildcard * is kept as TupleTable::kAny, which matches any value.
+  // Returns false on a tuple with wildcards exceeding the maximum wildcard
+  // arity, the remaining tuples are not collected.
+  static bool CollectIntTuples(Relation::TupleSet* tuples,
                                const std::string& content);
 
   // Collects ints in given content separated by given delimeters.
@@ -191,6 +195,7 @@ class Parser {
   void LoadRelations(Instance* instance, const size_t pos) const;
 
   // Loads the next relation element and returns its end position.
+  // Dies if wildcard tuples exceed the maximum wildcard arity.
   size_t LoadRelation(Relation* relation, const size_t pos) const;
 
   // Loads the next constraints element.
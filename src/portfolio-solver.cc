@@ -0,0 +1,164 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include "./portfolio-solver.h"
+#include <cassert>
+#include <thread>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include "./clock.h"
+#include "./network.h"
+
+using std::string;
+using std::vector;
+using std::thread;
+using std::mutex;
+using std::lock_guard;
+using std::min;
+using std::max;
+using base::Clock;
+
+namespace ace {
+
+// Winner id used while no strategy has decided the network.
+static const int kNoWinner = -1;
+
+PortfolioSolver::PortfolioSolver(const Network& network)
+    : Solver(),
+      network_(network),
+      time_limit_(Solver::kDefTimeLimit),
+      max_num_solutions_(Solver::kDefMaxNumSolutions) {
+  Reset();
+}
+
+PortfolioSolver::~PortfolioSolver() {
+  for (auto it = strategies_.begin(), end = strategies_.end();
+       it != end; ++it) {
+    delete it->solver;
+  }
+  for (auto it = networks_.begin(), end = networks_.end(); it != end; ++it) {
+    delete *it;
+  }
+}
+
+Network* PortfolioSolver::CreateNetwork() {
+  networks_.push_back(new Network(network_));
+  return networks_.back();
+}
+
+void PortfolioSolver::AddStrategy(const string& name, Solver* solver,
+                                  const bool complete) {
+  assert(solver);
+  // The strategies run concurrently, each within the time limit.
+  solver->clock_type(Clock::kThreadTime);
+  strategies_.push_back(Strategy(name, solver, complete));
+}
+
+bool PortfolioSolver::Solve() {
+  Reset();
+  const int num_strategies = strategies_.size();
+  vector<thread> threads;
+  threads.reserve(num_strategies);
+  for (int s = 0; s < num_strategies; ++s) {
+    threads.push_back(thread(&PortfolioSolver::Run, this, s));
+  }
+  for (auto it = threads.begin(), end = threads.end(); it != end; ++it) {
+    it->join();
+  }
+  if (winner_ != kNoWinner) {
+    duration_ = strategies_[winner_].solver->duration();
+    return solutions().size();
+  }
+  // An undecided network is reported as exceeding the time limit.
+  duration_ = time_limit_ + 1;
+  for (int s = 0; s < num_strategies; ++s) {
+    duration_ = max(duration_, strategies_[s].solver->duration());
+  }
+  return false;
+}
+
+void PortfolioSolver::Run(const int strategy_id) {
+  const Strategy& strategy = strategies_[strategy_id];
+  Solver* solver = strategy.solver;
+  solver->time_limit(time_limit_);
+  solver->max_num_solutions(max_num_solutions_);
+  const bool sat = solver->Solve();
+  // A failed search proves unsatisfiability only if it was not interrupted.
+  const bool decided = sat || (strategy.complete && !solver->cancelled() &&
+                               solver->duration() <= solver->time_limit());
+  if (decided) {
+    lock_guard<mutex> lock(mutex_);
+    if (winner_ == kNoWinner) {
+      winner_ = strategy_id;
+      const int num_strategies = strategies_.size();
+      for (int s = 0; s < num_strategies; ++s) {
+        if (s != strategy_id) {
+          strategies_[s].solver->Cancel();
+        }
+      }
+    }
+  }
+}
+
+void PortfolioSolver::Cancel() {
+  Solver::Cancel();
+  for (auto it = strategies_.begin(), end = strategies_.end();
+       it != end; ++it) {
+    it->solver->Cancel();
+  }
+}
+
+void PortfolioSolver::Reset() {
+  winner_ = kNoWinner;
+  duration_ = 0;
+}
+
+void PortfolioSolver::time_limit(const Clock::Diff& limit) {
+  time_limit_ = min(limit, Solver::kDefTimeLimit);
+}
+
+Clock::Diff PortfolioSolver::time_limit() const {
+  return time_limit_;
+}
+
+void PortfolioSolver::max_num_solutions(const int num) {
+  max_num_solutions_ = num > 0 ? num : Solver::kDefMaxNumSolutions;
+}
+
+int PortfolioSolver::max_num_solutions() const {
+  return max_num_solutions_;
+}
+
+const vector<Assignment>& PortfolioSolver::solutions() const {
+  if (winner_ == kNoWinner) {
+    return no_solutions_;
+  }
+  return strategies_[winner_].solver->solutions();
+}
+
+Clock::Diff PortfolioSolver::duration() const {
+  return duration_;
+}
+
+int PortfolioSolver::num_backtracks() const {
+  if (winner_ == kNoWinner) {
+    return 0;
+  }
+  return strategies_[winner_].solver->num_backtracks();
+}
+
+double PortfolioSolver::num_explored_states() const {
+  if (winner_ == kNoWinner) {
+    return 0.0;
+  }
+  return strategies_[winner_].solver->num_explored_states();
+}
+
+string PortfolioSolver::winner() const {
+  return winner_ == kNoWinner ? "" : strategies_[winner_].name;
+}
+
+int PortfolioSolver::num_strategies() const {
+  return strategies_.size();
+}
+
+}  // namespace ace
@@ -0,0 +1,109 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#ifndef SRC_PORTFOLIO_SOLVER_H_
+#define SRC_PORTFOLIO_SOLVER_H_
+
+#include <mutex>
+#include <string>
+#include <vector>
+#include "./solver.h"
+#include "./clock.h"
+#include "./assignment.h"
+
+namespace ace {
+
+// The constraint network.
+class Network;
+
+// A portfolio of solving strategies, which are run concurrently on separate
+// threads, each on its own copy of the network. The first strategy to decide
+// the network cancels all other strategies.
+class PortfolioSolver : public Solver {
+ public:
+  // Initialises the empty portfolio for the given network.
+  explicit PortfolioSolver(const Network& network);
+
+  // Deletes all strategy solvers and network copies.
+  ~PortfolioSolver();
+
+  // Returns a new copy of the network, which is owned by the portfolio. The
+  // solver of a new strategy needs to be created on such a copy.
+  Network* CreateNetwork();
+
+  // Adds a strategy, the portfolio takes ownership of the solver. A complete
+  // strategy proves unsatisfiability when its search fails without
+  // interruption, an incomplete strategy can only prove satisfiability.
+  void AddStrategy(const std::string& name, Solver* solver,
+                   const bool complete);
+
+  // Searches for a solution for the network running all strategies
+  // concurrently.
+  // Returns whether it found a solution.
+  bool Solve();
+
+  // Cancels all strategies.
+  void Cancel();
+
+  // Resets the solver meta-information, which is collected during search.
+  void Reset();
+
+  // Sets the time limit for the search. Search will be terminated if the time
+  // limit is exceeded, returning false.
+  void time_limit(const base::Clock::Diff& limit);
+
+  // Returns the set time limit.
+  base::Clock::Diff time_limit() const;
+
+  // Sets the maximum number of solutions to be searched for.
+  void max_num_solutions(const int num);
+
+  // Returns the set maximum number of solutions to be searched for.
+  int max_num_solutions() const;
+
+  // Returns a const reference to the solutions found by the winning strategy.
+  const std::vector<Assignment>& solutions() const;
+
+  // Returns the duration of the winning strategy search in microseconds.
+  // Exceeds the time limit if no strategy has decided the network.
+  base::Clock::Diff duration() const;
+
+  // Returns the number of backtracks used by the winning strategy.
+  int num_backtracks() const;
+
+  // Returns the number of states explored by the winning strategy.
+  double num_explored_states() const;
+
+  // Returns the name of the winning strategy, empty if no strategy has decided
+  // the network.
+  std::string winner() const;
+
+  // Returns the number of strategies.
+  int num_strategies() const;
+
+ private:
+  // A portfolio solving strategy.
+  struct Strategy {
+    Strategy(const std::string& name, Solver* solver, const bool complete)
+        : name(name),
+          solver(solver),
+          complete(complete) {}
+    std::string name;
+    Solver* solver;
+    bool complete;
+  };
+
+  // Runs the search of given strategy, executed on a separate thread.
+  void Run(const int strategy_id);
+
+  const Network& network_;
+  std::vector<Network*> networks_;
+  std::vector<Strategy> strategies_;
+  std::vector<Assignment> no_solutions_;
+  std::mutex mutex_;
+  int winner_;
+  base::Clock::Diff duration_;
+  base::Clock::Diff time_limit_;
+  int max_num_solutions_;
+};
+
+}  // namespace ace
+#endif  // SRC_PORTFOLIO_SOLVER_H_
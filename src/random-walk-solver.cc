@@ -9,6 +9,7 @@
 #include "./network.h"
 #include "./variable-ordering.h"
 #include "./random.h"
+#include "./conflict-table.h"
 
 using std::vector;
 using std::set;
@@ -18,69 +19,107 @@ using std::numeric_limits;
 using std::min;
 using std::max;
 using std::swap;
+using std::mutex;
+using std::lock_guard;
 
 namespace ace {
 
+SharedAssignment::SharedAssignment()
+    : num_violated_(numeric_limits<int>::max()) {}
+
+void SharedAssignment::Offer(const Assignment& assignment,
+                             const int num_violated) {
+  lock_guard<mutex> lock(mutex_);
+  if (num_violated < num_violated_) {
+    num_violated_ = num_violated;
+    const int size = assignment.size();
+    values_.resize(size);
+    for (int v = 0; v < size; ++v) {
+      values_[v] = assignment.value(v);
+    }
+  }
+}
+
+bool SharedAssignment::Get(vector<int>* values) const {
+  lock_guard<mutex> lock(mutex_);
+  if (values_.empty()) {
+    return false;
+  }
+  *values = values_;
+  return true;
+}
+
 const int RandomWalkSolver::kDefMaxNumTries = 100;
 const int RandomWalkSolver::kDefMaxNumFlips = 100;
+const int RandomWalkSolver::kDefRandomProbability = 20;
 
 RandomWalkSolver::RandomWalkSolver(Network* network)
     : Solver(),
       network_(*network),
       time_limit_(Solver::kDefTimeLimit),
       max_num_solutions_(Solver::kDefMaxNumSolutions),
-      random_gen_(Clock().value() ^ 0x5a8aff10) {
+      max_num_tries_(kDefMaxNumTries),
+      max_num_flips_(kDefMaxNumFlips),
+      random_probability_(kDefRandomProbability),
+      random_gen_(Clock().value() ^ 0x5a8aff10),
+      shared_(nullptr) {
   Reset();
 }
 
 bool RandomWalkSolver::Solve() {
   Reset();
-  begin_clock_ = Clock();
+  begin_clock_ = Clock(clock_type_);
+  solutions_.clear();
+  num_solutions_ = 0;
 
   const int num_constraints = network_.num_constraints();
+  ConflictTable table(network_);
   Assignment best_assignment = RandomAssignment();
   const int best_score = best_assignment.num_violated_constraints();
   for (int t = 0; t < max_num_tries_; ++t) {
-    if (solutions_.size() >= max_num_solutions_) {
+    if (num_solutions_ >= max_num_solutions_ || cancelled_ ||
+        Clock(clock_type_) - begin_clock_ > time_limit_) {
+      // Enough solutions found, search cancelled or time limit reached.
       break;
     }
-    Assignment assignment = RandomAssignment();
-    const int score = assignment.num_violated_constraints();
+    Assignment assignment = SharedOrRandomAssignment(t);
+    table.Init(assignment);
+    const int score = table.num_violated_constraints();
     if (score < best_score) {
       best_assignment = assignment;
     }
-    for (int f = 0; f < max_num_flips_; ++f) {
-      if (assignment.Consistent()) {
+    for (int f = 0; f < max_num_flips_ && !cancelled_; ++f) {
+      if (!table.num_violated_constraints()) {
         // Solution found.
-        solutions_.push_back(assignment);
+        assert(assignment.Consistent());
+        AddSolution(assignment, &solutions_);
         break;
       }
-      const vector<int> violated_cons = assignment.violated_constraints();
+      const vector<int>& violated_cons = table.violated_constraints();
       // Select a random violated constraint.
       const int constraint_id = violated_cons[random_gen_.Next() *
                                               violated_cons.size()];
       const Constraint& constraint = network_.constraint(constraint_id);
       const int scope_size = constraint.scope().size();
       const int random_step = random_gen_.Next() * 100 < random_probability_;
-      int variable = 0;
-      int value = assignment.value(variable);
+      int variable = constraint.scope(0);
+      int value = table.value(variable);
       if (random_step) {
-        // Random walk step.
+        // Random walk step, changes a random variable of the constraint to
+        // another random value. Variables with a single value are skipped.
         ++num_random_steps_;
-        const float var_chance = 1.0f / scope_size;
-        while (value == assignment.value(variable)) {
-          for (int i = 0; i < scope_size; ++i) {
-            if (random_gen_.Next() * scope_size < var_chance) {
-              const int var_id = constraint.scope(i);
-              const Variable& var = network_.variable(var_id);
-              const vector<int>& domain = var.domain();
-              const int num_values = domain.size();
-              if (num_values) {
-                variable = var_id;
-                value = domain[random_gen_.Next() * num_values];
-                break;
-              }
+        const int first = random_gen_.Next() * scope_size;
+        for (int i = 0; i < scope_size; ++i) {
+          const int var_id = constraint.scope((first + i) % scope_size);
+          const vector<int>& domain = table.domain(var_id);
+          const int num_values = domain.size();
+          if (num_values > 1) {
+            variable = var_id;
+            value = domain[random_gen_.Next() * (num_values - 1)];
+            if (value == table.value(var_id)) {
+              value = domain.back();
             }
+            break;
           }
         }
       } else {
@@ -91,28 +130,32 @@ bool RandomWalkSolver::Solve() {
         int best_score = num_constraints;
         for (int i = 0; i < scope_size; ++i) {
           const int var_id = constraint.scope(i);
-          const int org_value = assignment.value(var_id);
-          const Variable& var = network_.variable(var_id);
-          const vector<int>& domain = var.domain();
+          const vector<int>& domain = table.domain(var_id);
           for (auto it = domain.cbegin(), end = domain.cend();
                it != end; ++it) {
-            assignment.Reassign(var_id, *it);
-            const int new_score = assignment.num_violated_constraints();
+            const int new_score = table.Score(var_id, *it);
             if (new_score - even < best_score) {
               best_score = new_score;
               variable = var_id;
               value = *it;
             }
           }
-          assignment.Reassign(var_id, org_value);
         }
       }
+      table.Flip(variable, value);
       assignment.Reassign(variable, value);
     }
+    if (shared_) {
+      shared_->Offer(assignment, table.num_violated_constraints());
+    }
   }
 
-  duration_ = Clock() - begin_clock_;
-  return solutions_.size();
+  duration_ = Clock(clock_type_) - begin_clock_;
+  return num_solutions_;
+}
+
+bool RandomWalkSolver::complete() const {
+  return false;
 }
 
 Assignment RandomWalkSolver::RandomAssignment() {
@@ -120,13 +163,26 @@ Assignment RandomWalkSolver::RandomAssignment() {
   const int num_variables = network_.num_variables();
   for (int v = 0; v < num_variables; ++v) {
     const Variable& var = network_.variable(v);
-    const vector<int>& domain = var.domain();
+    const vector<int> domain = var.valid_value_ids();
     const int value = domain[random_gen_.Next() * domain.size()];
     assignment.Assign(v, value);
   }
   return assignment;
 }
 
+Assignment RandomWalkSolver::SharedOrRandomAssignment(const int try_id) {
+  vector<int> values;
+  if (!shared_ || try_id % 2 == 0 || !shared_->Get(&values)) {
+    return RandomAssignment();
+  }
+  Assignment assignment(network_);
+  const int num_variables = values.size();
+  for (int v = 0; v < num_variables; ++v) {
+    assignment.Assign(v, values[v]);
+  }
+  return assignment;
+}
+
 void RandomWalkSolver::Reset() {
   duration_ = 0;
   num_backtracks_ = 0;
@@ -147,6 +203,14 @@ void RandomWalkSolver::random_probability(const int p) {
   random_probability_ = max(0, p);
 }
 
+void RandomWalkSolver::seed(const uint32_t seed) {
+  random_gen_ = RandomGenerator<float>(seed);
+}
+
+void RandomWalkSolver::shared_assignment(SharedAssignment* shared) {
+  shared_ = shared;
+}
+
 int RandomWalkSolver::max_num_tries() const {
   return max_num_tries_;
 }
@@ -2,6 +2,7 @@
 #ifndef SRC_RANDOM_WALK_SOLVER_H_
 #define SRC_RANDOM_WALK_SOLVER_H_
 
+#include <mutex>
 #include <vector>
 #include "./solver.h"
 #include "./clock.h"
@@ -13,13 +14,34 @@ namespace ace {
 // The constraint network.
 class Network;
 
-// A constraint network solver based on Gaschnig's backjumping.
+// An assignment shared among concurrent random walks, keeping the one with the
+// fewest violated constraints.
+class SharedAssignment {
+ public:
+  SharedAssignment();
+
+  // Offers the complete assignment with given number of violated constraints,
+  // which replaces the shared assignment if it has fewer violations.
+  void Offer(const Assignment& assignment, const int num_violated);
+
+  // Copies the shared values (by id) into the vector.
+  // Returns false if no assignment was offered yet.
+  bool Get(std::vector<int>* values) const;
+
+ private:
+  mutable std::mutex mutex_;
+  std::vector<int> values_;
+  int num_violated_;
+};
+
+// A constraint network solver based on random walks with greedy steps.
 class RandomWalkSolver : public Solver {
  public:
   static const base::Clock::Diff kDefTimeLimit;
   static const int kDefMaxNumSolutions;
   static const int kDefMaxNumTries;
   static const int kDefMaxNumFlips;
+  static const int kDefRandomProbability;
 
   // Initialises the solver with the given network.
   explicit RandomWalkSolver(Network* network);
@@ -28,6 +50,9 @@ class RandomWalkSolver : public Solver {
   // Returns whether it found a solution.
   bool Solve();
 
+  // Returns false, the search can only prove satisfiability.
+  bool complete() const;
+
   // Resets the solver meta-information, which is collected during search.
   void Reset();
 
@@ -38,6 +63,14 @@ class RandomWalkSolver : public Solver {
   int max_num_flips() const;
   int random_probability() const;
 
+  // Sets the seed of the random generator, which is time-based by default.
+  void seed(const uint32_t seed);
+
+  // Sets the assignment shared with concurrent walks. Each walk offers its
+  // final assignment of a try and starts every second try from the shared one
+  // (nullptr for independent tries).
+  void shared_assignment(SharedAssignment* shared);
+
   // Sets the time limit for the search. Search will be terminated if the time
   // limit is exceeded, returning false.
   void time_limit(const base::Clock::Diff& limit);
@@ -71,6 +104,7 @@ class RandomWalkSolver : public Solver {
 
  private:
   Assignment RandomAssignment();
+  Assignment SharedOrRandomAssignment(const int try_id);
   bool SelectValue(const int var_seq, Assignment* assignment);
 
   Network& network_;
@@ -87,6 +121,7 @@ class RandomWalkSolver : public Solver {
   int max_num_flips_;
   int random_probability_;
   base::RandomGenerator<float> random_gen_;
+  SharedAssignment* shared_;
 };
 
 }  // namespace ace
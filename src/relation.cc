@@ -25,16 +25,6 @@ bool Relation::VectorLess::operator()(const Tuple& lhs,
   return i < size && lhs[i] < rhs[i];
 }
 
-size_t Relation::TupleHash::operator()(const Tuple& tuple) const {
-  const int size = tuple.size();
-  size_t h = size ^ 0x550944F8;
-  for (int i = 0; i < size; ++i) {
-    const int j = i * 3;
-    h ^= (tuple[i] << j) ^ (h >> j);
-  }
-  return h;
-}
-
 Relation::Relation(const string& name, const Semantics semantics,
                    const TupleSet& tuples)
     : supporting_(semantics == kSupports),
@@ -42,7 +32,7 @@ Relation::Relation(const string& name, const Semantics semantics,
       name_(name) {}
 
 bool Relation::Supports(const vector<int>& values) const {
-  const bool matched = tuples_.find(values) != tuples_.end();
+  const bool matched = tuples_.Matches(values);
   // The relation supports the given tuple iff
   // - tuple is in the relation and it is a supporting relation or
   // - the tuple is not in the relation and it is a conflicting relation.
@@ -55,9 +45,9 @@ bool Relation::Conflicts(const vector<int>& values) const {
 
 void Relation::AddConflicting(const Tuple& tuple) {
   if (supporting_) {
-    tuples_.erase(tuple);
+    tuples_.Erase(tuple);
   } else {
-    tuples_.insert(tuple);
+    tuples_.Insert(tuple);
   }
 }
 
@@ -71,7 +61,7 @@ Relation::TupleSet& Relation::tuples() {
 
 Relation::TupleSet Relation::Supporting(const std::vector<std::vector<int> >&
                                         domains) const {
-  TupleSet supporting;
+  TupleSet supporting(domains.size());
   vector<int> indices(domains.size(), 0);
   vector<int> values;
   values.reserve(domains.size());
@@ -81,7 +71,7 @@ Relation::TupleSet Relation::Supporting(const std::vector<std::vector<int> >&
     values.push_back(*d.begin());
   }
   if (Supports(values)) {
-    supporting.insert(values);
+    supporting.Insert(values);
   }
   size_t i = 0;
   while (i < values.size()) {
@@ -93,7 +83,7 @@ Relation::TupleSet Relation::Supporting(const std::vector<std::vector<int> >&
     if (i < values.size()) {
       values[i] = domains[i][++indices[i]];
       if (Supports(values)) {
-        supporting.insert(values);
+        supporting.Insert(values);
       }
     }
   }
@@ -102,7 +92,7 @@ Relation::TupleSet Relation::Supporting(const std::vector<std::vector<int> >&
 
 Relation::TupleSet Relation::Supporting(const vector<const vector<int>*>&
                                         domains) const {
-  TupleSet supporting;
+  TupleSet supporting(domains.size());
   vector<int> indices(domains.size(), 0);
   vector<int> values;
   values.reserve(domains.size());
@@ -112,7 +102,7 @@ Relation::TupleSet Relation::Supporting(const vector<const vector<int>*>&
     values.push_back(*d.begin());
   }
   if (Supports(values)) {
-    supporting.insert(values);
+    supporting.Insert(values);
   }
   size_t i = 0;
   while (i < values.size()) {
@@ -124,7 +114,7 @@ Relation::TupleSet Relation::Supporting(const vector<const vector<int>*>&
     if (i < values.size()) {
       values[i] = (*domains[i])[++indices[i]];
       if (Supports(values)) {
-        supporting.insert(values);
+        supporting.Insert(values);
       }
     }
   }
@@ -133,7 +123,7 @@ Relation::TupleSet Relation::Supporting(const vector<const vector<int>*>&
 
 Relation::TupleSet Relation::Conflicting(const std::vector<std::vector<int> >&
                                          domains) const {
-  TupleSet conflicting;
+  TupleSet conflicting(domains.size());
   vector<int> indices(domains.size(), 0);
   vector<int> values;
   for (auto it = domains.begin(), end = domains.end(); it != end; ++it) {
@@ -142,7 +132,7 @@ Relation::TupleSet Relation::Conflicting(const std::vector<std::vector<int> >&
     values.push_back(*d.begin());
   }
   if (Conflicts(values)) {
-    conflicting.insert(values);
+    conflicting.Insert(values);
   }
   size_t i = 0;
   while (i < values.size()) {
@@ -154,7 +144,7 @@ Relation::TupleSet Relation::Conflicting(const std::vector<std::vector<int> >&
     if (i < values.size()) {
       values[i] = domains[i][++indices[i]];
       if (Conflicts(values)) {
-        conflicting.insert(values);
+        conflicting.Insert(values);
       }
     }
   }
@@ -163,7 +153,7 @@ Relation::TupleSet Relation::Conflicting(const std::vector<std::vector<int> >&
 
 Relation::TupleSet Relation::Conflicting(const vector<const vector<int>*>&
                                          domains) const {
-  TupleSet conflicting;
+  TupleSet conflicting(domains.size());
   vector<int> indices(domains.size(), 0);
   vector<int> values;
   for (auto it = domains.begin(), end = domains.end(); it != end; ++it) {
@@ -172,7 +162,7 @@ Relation::TupleSet Relation::Conflicting(const vector<const vector<int>*>&
     values.push_back(*d.begin());
   }
   if (Conflicts(values)) {
-    conflicting.insert(values);
+    conflicting.Insert(values);
   }
   size_t i = 0;
   while (i < values.size()) {
@@ -184,7 +174,7 @@ Relation::TupleSet Relation::Conflicting(const vector<const vector<int>*>&
     if (i < values.size()) {
       values[i] = (*domains[i])[++indices[i]];
       if (Conflicts(values)) {
-        conflicting.insert(values);
+        conflicting.Insert(values);
       }
     }
   }
@@ -201,16 +191,21 @@ const string& Relation::name() const {
 
 string Relation::UniStr(const Relation::TupleSet& tuples) {
   stringstream ss;
-  for (auto it = tuples.begin(); it != tuples.end(); ++it) {
-    const Tuple& t = *it;
-    if (it != tuples.begin()) {
+  const int arity = tuples.arity();
+  for (size_t i = 0, size = tuples.size(); i < size; ++i) {
+    const int* tuple = tuples.tuple(i);
+    if (i != 0) {
       ss << ", ";
     }
-    for (auto it2 = t.begin(); it2 != t.end(); ++it2) {
-      if (it2 != t.begin()) {
+    for (int j = 0; j < arity; ++j) {
+      if (j != 0) {
         ss << " ";
       }
-      ss << *it2;
+      if (tuple[j] == TupleTable::kAny) {
+        ss << "*";
+      } else {
+        ss << tuple[j];
+      }
     }
   }
   return ss.str();
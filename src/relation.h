@@ -2,10 +2,10 @@
 #ifndef SRC_RELATION_H_
 #define SRC_RELATION_H_
 
-#include <unordered_set>
 #include <string>
 #include <vector>
 #include <set>
+#include "./tuple-table.h"
 
 namespace ace {
 
@@ -22,12 +22,7 @@ class Relation {
     bool operator()(const Tuple& lhs, const Tuple& rhs) const;
   };
 
-  struct TupleHash {
-    size_t operator()(const Tuple& tuple) const;
-  };
-
-  // typedef std::set<Tuple, VectorLess> TupleSet;
-  typedef std::unordered_set<Tuple, TupleHash> TupleSet;
+  typedef TupleTable TupleSet;
 
   static std::string UniStr(const TupleSet& tuples);
 
@@ -0,0 +1,95 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include "./solution-sink.h"
+#include "./assignment.h"
+#include "./network.h"
+#include "./interchangeability.h"
+
+using std::mutex;
+using std::lock_guard;
+
+namespace ace {
+
+SolutionSink::SolutionSink()
+    : num_solutions_(0) {}
+
+void SolutionSink::Add(const Assignment& assignment) {
+  lock_guard<mutex> lock(mutex_);
+  ++num_solutions_;
+  Write(assignment);
+}
+
+void SolutionSink::AddCount(const int64_t num) {
+  lock_guard<mutex> lock(mutex_);
+  num_solutions_ += num;
+}
+
+bool SolutionSink::counting() const {
+  return false;
+}
+
+int64_t SolutionSink::num_solutions() const {
+  return num_solutions_;
+}
+
+bool CountingSink::counting() const {
+  return true;
+}
+
+void CountingSink::Write(const Assignment& assignment) {}
+
+FirstSolutionSink::FirstSolutionSink()
+    : first_(nullptr) {}
+
+FirstSolutionSink::~FirstSolutionSink() {
+  delete first_;
+}
+
+const Assignment* FirstSolutionSink::first() const {
+  return first_;
+}
+
+void FirstSolutionSink::Write(const Assignment& assignment) {
+  if (!first_) {
+    first_ = new Assignment(assignment);
+  }
+}
+
+StreamSink::StreamSink(const Network& network, std::ostream* stream)
+    : network_(network),
+      stream_(stream) {}
+
+void StreamSink::Write(const Assignment& assignment) {
+  const int size = assignment.size();
+  for (int i = 0; i < size; ++i) {
+    if (i != 0) {
+      *stream_ << ' ';
+    }
+    *stream_ << network_.variable(i).value(assignment.value(i));
+  }
+  *stream_ << '\n';
+}
+
+InterchangeableSink::InterchangeableSink(
+    const Interchangeability& interchangeability,
+    const int64_t max_num_solutions, SolutionSink* sink)
+    : interchangeability_(interchangeability),
+      max_num_solutions_(max_num_solutions),
+      sink_(sink) {}
+
+void InterchangeableSink::Write(const Assignment& assignment) {
+  const int64_t num_solutions = sink_->num_solutions();
+  if (num_solutions >= max_num_solutions_) {
+    return;
+  }
+  const int64_t num_remaining = max_num_solutions_ - num_solutions;
+  if (sink_->counting()) {
+    const double num_expansions =
+      interchangeability_.num_expansions(assignment);
+    sink_->AddCount(num_expansions < num_remaining ?
+                    static_cast<int64_t>(num_expansions) : num_remaining);
+    return;
+  }
+  interchangeability_.Expand(assignment, num_remaining, sink_);
+}
+
+}  // namespace ace
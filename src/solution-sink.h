@@ -0,0 +1,106 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#ifndef SRC_SOLUTION_SINK_H_
+#define SRC_SOLUTION_SINK_H_
+
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+
+namespace ace {
+
+class Network;
+class Assignment;
+class Interchangeability;
+
+// A receiver of the solutions found during search. Solvers pass their
+// solutions to a sink as they are found instead of storing them, which keeps
+// the memory usage constant when enumerating many solutions.
+class SolutionSink {
+ public:
+  SolutionSink();
+
+  virtual ~SolutionSink() {}
+
+  // Records the solution. Safe to be called from multiple threads.
+  void Add(const Assignment& assignment);
+
+  // Records the given number of solutions without handling them, used for
+  // sinks which only count. Safe to be called from multiple threads.
+  void AddCount(const int64_t num);
+
+  // Returns whether the sink only counts the solutions.
+  virtual bool counting() const;
+
+  // Returns the number of recorded solutions.
+  int64_t num_solutions() const;
+
+ protected:
+  // Handles the solution, called with the sink lock held.
+  virtual void Write(const Assignment& assignment) = 0;
+
+ private:
+  std::mutex mutex_;
+  int64_t num_solutions_;
+};
+
+// A sink which only counts the solutions.
+class CountingSink : public SolutionSink {
+ public:
+  bool counting() const;
+
+ protected:
+  void Write(const Assignment& assignment);
+};
+
+// A sink which counts the solutions and keeps the first one.
+class FirstSolutionSink : public SolutionSink {
+ public:
+  FirstSolutionSink();
+
+  // Deletes the kept solution.
+  ~FirstSolutionSink();
+
+  // Returns the first recorded solution, nullptr if none was recorded.
+  const Assignment* first() const;
+
+ protected:
+  void Write(const Assignment& assignment);
+
+ private:
+  Assignment* first_;
+};
+
+// A sink which writes the solutions to a stream, one solution per line given
+// by the values of the variables in order of their ids.
+class StreamSink : public SolutionSink {
+ public:
+  StreamSink(const Network& network, std::ostream* stream);
+
+ protected:
+  void Write(const Assignment& assignment);
+
+ private:
+  const Network& network_;
+  std::ostream* stream_;
+};
+
+// A sink which expands the solutions of a network with merged interchangeable
+// values and passes the expanded solutions to another sink, up to the given
+// maximum number of solutions. Counting sinks only receive the number of
+// expanded solutions.
+class InterchangeableSink : public SolutionSink {
+ public:
+  InterchangeableSink(const Interchangeability& interchangeability,
+                      const int64_t max_num_solutions, SolutionSink* sink);
+
+ protected:
+  void Write(const Assignment& assignment);
+
+ private:
+  const Interchangeability& interchangeability_;
+  int64_t max_num_solutions_;
+  SolutionSink* sink_;
+};
+
+}  // namespace ace
+#endif  // SRC_SOLUTION_SINK_H_
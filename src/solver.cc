@@ -2,15 +2,66 @@
 #include "./solver.h"
 #include <limits>
 #include "./clock.h"
+#include "./solution-sink.h"
 
 using base::Clock;
 using std::numeric_limits;
+using std::vector;
 
 namespace ace {
 
 const Clock::Diff Solver::kDefTimeLimit = numeric_limits<Clock::Diff>::max() -
                                           Clock::kMicroInSec * 10;
 const int Solver::kDefMaxNumSolutions = numeric_limits<int>::max();
+const Clock::Diff Solver::kMaxWaitTime = Clock::kMicroInMin * 60 * 24 * 365;
+
+Solver::Solver()
+    : cancelled_(false),
+      sink_(nullptr),
+      clock_type_(Clock::kProcessTime),
+      num_solutions_(0) {}
+
+void Solver::Cancel() {
+  cancelled_ = true;
+}
+
+bool Solver::cancelled() const {
+  return cancelled_;
+}
+
+bool Solver::complete() const {
+  return true;
+}
+
+void Solver::solution_sink(SolutionSink* sink) {
+  sink_ = sink;
+}
+
+SolutionSink* Solver::solution_sink() const {
+  return sink_;
+}
+
+void Solver::clock_type(const clockid_t type) {
+  clock_type_ = type;
+}
+
+clockid_t Solver::clock_type() const {
+  return clock_type_;
+}
+
+int Solver::num_solutions() const {
+  return num_solutions_;
+}
+
+void Solver::AddSolution(const Assignment& assignment,
+                         vector<Assignment>* solutions) {
+  ++num_solutions_;
+  if (sink_) {
+    sink_->Add(assignment);
+  } else {
+    solutions->push_back(assignment);
+  }
+}
 
 }  // namespace ace
 
@@ -2,6 +2,7 @@
 #ifndef SRC_SOLVER_H_
 #define SRC_SOLVER_H_
 
+#include <atomic>
 #include <vector>
 #include "./clock.h"
 #include "./assignment.h"
@@ -9,11 +10,18 @@
 
 namespace ace {
 
+class SolutionSink;
+
 // A constraint network solver base class. Handles general solver options.
 class Solver {
  public:
   static const base::Clock::Diff kDefTimeLimit;
   static const int kDefMaxNumSolutions;
+  // The longest time limit enforced by waiting for parallel searches, larger
+  // limits would overflow the steady clock and are considered unlimited.
+  static const base::Clock::Diff kMaxWaitTime;
+
+  Solver();
 
   virtual ~Solver() {}
 
@@ -21,6 +29,18 @@ class Solver {
   // Returns whether it found a solution.
   virtual bool Solve() = 0;
 
+  // Requests the termination of the search, which is cooperative: a running
+  // search stops at its next time limit check, returning false. Safe to be
+  // called from other threads.
+  virtual void Cancel();
+
+  // Returns whether the termination of the search has been requested.
+  bool cancelled() const;
+
+  // Returns whether the search is complete, i.e. a search which ends without
+  // a solution and within the time limit proves unsatisfiability.
+  virtual bool complete() const;
+
   // Resets the solver meta-information, which is collected during search.
   virtual void Reset() = 0;
 
@@ -38,8 +58,27 @@ class Solver {
   virtual int max_num_solutions() const = 0;
 
   // Returns a const reference to the solutions found by the last search.
+  // Solutions passed to a sink are not stored.
   virtual const std::vector<Assignment>& solutions() const = 0;
 
+  // Sets the sink receiving the solutions as they are found, instead of them
+  // being stored (nullptr for storing the solutions). The sink is not owned.
+  virtual void solution_sink(SolutionSink* sink);
+
+  // Returns the set solution sink.
+  SolutionSink* solution_sink() const;
+
+  // Sets the clock measuring the duration and time limit of the search,
+  // process time by default.
+  void clock_type(const clockid_t type);
+
+  // Returns the set clock type.
+  clockid_t clock_type() const;
+
+  // Returns the number of solutions found by the last search, including the
+  // ones passed to the sink.
+  int num_solutions() const;
+
   // Returns the duration of the last search in microseconds.
   virtual base::Clock::Diff duration() const = 0;
 
@@ -48,6 +87,16 @@ class Solver {
 
   // Returns the number of states explored during the last search.
   virtual double num_explored_states() const = 0;
+
+ protected:
+  // Passes the solution to the sink or stores it if no sink is set.
+  void AddSolution(const Assignment& assignment,
+                   std::vector<Assignment>* solutions);
+
+  std::atomic<bool> cancelled_;
+  SolutionSink* sink_;
+  clockid_t clock_type_;
+  size_t num_solutions_;
 };
 
 }  // namespace ace
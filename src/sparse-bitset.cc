@@ -0,0 +1,133 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include "./sparse-bitset.h"
+#include <cassert>
+
+using std::vector;
+
+namespace ace {
+
+SparseBitset::SparseBitset(const int num_bits)
+    : words_((num_bits + 63) / 64, ~uint64_t(0)),
+      index_(words_.size()),
+      limit_(words_.size()),
+      mask_(words_.size(), 0) {
+  assert(num_bits >= 0);
+  if (num_bits % 64) {
+    words_.back() = (uint64_t(1) << (num_bits % 64)) - 1;
+  }
+  for (int i = 0; i < limit_; ++i) {
+    index_[i] = i;
+  }
+}
+
+void SparseBitset::StartTransaction() {
+  transactions_.push_back(false);
+}
+
+void SparseBitset::CommitTransaction() {
+  assert(transactions_.size());
+  if (transactions_.back()) {
+    // Something has been modified in this transaction.
+    assert(snapshots_.size());
+    snapshots_.pop_back();
+  }
+  transactions_.pop_back();
+}
+
+void SparseBitset::RollbackTransaction() {
+  assert(transactions_.size());
+  if (transactions_.back()) {
+    // Something has been modified in this transaction. The words in front of
+    // the limit are only permuted among themselves.
+    assert(snapshots_.size());
+    const Snapshot& snapshot = snapshots_.back();
+    limit_ = snapshot.limit;
+    for (int i = 0; i < limit_; ++i) {
+      index_[i] = snapshot.index[i];
+      words_[index_[i]] = snapshot.words[i];
+    }
+    snapshots_.pop_back();
+  }
+  transactions_.pop_back();
+}
+
+void SparseBitset::ClearMask() {
+  for (int i = 0; i < limit_; ++i) {
+    mask_[index_[i]] = 0;
+  }
+}
+
+void SparseBitset::AddToMask(const vector<uint64_t>& bits) {
+  assert(bits.size() == words_.size());
+  for (int i = 0; i < limit_; ++i) {
+    const int w = index_[i];
+    mask_[w] |= bits[w];
+  }
+}
+
+void SparseBitset::IntersectWithMask() {
+  bool modified = false;
+  for (int i = limit_ - 1; i >= 0; --i) {
+    const int w = index_[i];
+    const uint64_t word = words_[w] & mask_[w];
+    if (word == words_[w]) {
+      continue;
+    }
+    if (!modified && transactions_.size() && !transactions_.back()) {
+      // We have not made a snapshot during this transaction yet.
+      snapshots_.push_back(Snapshot());
+      Snapshot& snapshot = snapshots_.back();
+      snapshot.limit = limit_;
+      snapshot.index.assign(index_.begin(), index_.begin() + limit_);
+      snapshot.words.resize(limit_);
+      for (int j = 0; j < limit_; ++j) {
+        snapshot.words[j] = words_[index_[j]];
+      }
+      transactions_.back() = true;
+    }
+    modified = true;
+    words_[w] = word;
+    if (!word) {
+      // Move the zero word behind the limit.
+      --limit_;
+      index_[i] = index_[limit_];
+      index_[limit_] = w;
+    }
+  }
+}
+
+int SparseBitset::IntersectIndex(const vector<uint64_t>& bits) const {
+  assert(bits.size() == words_.size());
+  for (int i = 0; i < limit_; ++i) {
+    const int w = index_[i];
+    if (words_[w] & bits[w]) {
+      return w;
+    }
+  }
+  return -1;
+}
+
+uint64_t SparseBitset::IntersectCount(const vector<uint64_t>& bits) const {
+  assert(bits.size() == words_.size());
+  uint64_t count = 0;
+  for (int i = 0; i < limit_; ++i) {
+    const int w = index_[i];
+    count += __builtin_popcountll(words_[w] & bits[w]);
+  }
+  return count;
+}
+
+uint64_t SparseBitset::word(const int index) const {
+  assert(index >= 0 && index < num_words());
+  return words_[index];
+}
+
+bool SparseBitset::empty() const {
+  return limit_ == 0;
+}
+
+int SparseBitset::num_words() const {
+  return words_.size();
+}
+
+}  // namespace ace
@@ -0,0 +1,71 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#ifndef SRC_SPARSE_BITSET_H_
+#define SRC_SPARSE_BITSET_H_
+
+#include <cstdint>
+#include <vector>
+
+namespace ace {
+
+// A reversible sparse bitset. Only the non-zero words are visited, they are
+// kept in front of a permutation of the word indices. Bits are only ever
+// removed, reversible by transactions like the variable domains.
+class SparseBitset {
+ public:
+  // Initialises the bitset with given number of bits, which are all set.
+  explicit SparseBitset(const int num_bits = 0);
+
+  // Starts a transaction. All modifications are recorded and reversable
+  // during the transaction.
+  void StartTransaction();
+
+  // Commits the transaction making the modifications persistent.
+  void CommitTransaction();
+
+  // Rolls back all modifications of the currently active transaction.
+  void RollbackTransaction();
+
+  // Clears the temporary mask.
+  void ClearMask();
+
+  // Adds the given bits to the temporary mask.
+  void AddToMask(const std::vector<uint64_t>& bits);
+
+  // Removes all bits which are not in the temporary mask.
+  void IntersectWithMask();
+
+  // Returns the index of a word with a bit set in both the bitset and given
+  // bits, or -1 if they are disjoint.
+  int IntersectIndex(const std::vector<uint64_t>& bits) const;
+
+  // Returns the number of bits set in both the bitset and given bits.
+  uint64_t IntersectCount(const std::vector<uint64_t>& bits) const;
+
+  // Returns the word at given index.
+  uint64_t word(const int index) const;
+
+  // Returns whether no bit is set.
+  bool empty() const;
+
+  // Returns the number of words.
+  int num_words() const;
+
+ private:
+  // The live words at the start of a transaction.
+  struct Snapshot {
+    int limit;
+    std::vector<int> index;
+    std::vector<uint64_t> words;
+  };
+
+  std::vector<uint64_t> words_;
+  // The word indices, the non-zero words are in front of limit_.
+  std::vector<int> index_;
+  int limit_;
+  std::vector<uint64_t> mask_;
+  std::vector<bool> transactions_;
+  std::vector<Snapshot> snapshots_;
+};
+
+}  // namespace ace
+#endif  // SRC_SPARSE_BITSET_H_
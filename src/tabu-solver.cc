@@ -0,0 +1,266 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include "./tabu-solver.h"
+#include <cassert>
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include "./clock.h"
+#include "./network.h"
+#include "./random.h"
+
+using std::vector;
+using std::numeric_limits;
+using std::min;
+using std::max;
+using std::fill;
+using base::Clock;
+using base::RandomGenerator;
+
+namespace ace {
+
+const int TabuSolver::kDefTabuTenure = 10;
+const int TabuSolver::kDefStallLimit = 100000;
+const uint32_t TabuSolver::kDefSeed = 0x5a8aff10;
+
+// The number of steps between time limit checks.
+static const int kCheckInterval = 256;
+
+TabuSolver::TabuSolver(Network* network)
+    : Solver(),
+      network_(*network),
+      table_(*network),
+      best_assignment_(*network),
+      var_marks_(network->num_variables(), 0),
+      tabu_tenure_(kDefTabuTenure),
+      stall_limit_(kDefStallLimit),
+      max_num_steps_(0),
+      time_limit_(Solver::kDefTimeLimit),
+      max_num_solutions_(Solver::kDefMaxNumSolutions),
+      random_gen_(kDefSeed) {
+  const int num_vars = network_.num_variables();
+  tabu_.resize(num_vars);
+  for (int v = 0; v < num_vars; ++v) {
+    tabu_[v].resize(network_.variable(v).num_values(), 0);
+  }
+  Reset();
+}
+
+bool TabuSolver::Solve() {
+  Reset();
+  begin_clock_ = Clock(clock_type_);
+  solutions_.clear();
+  num_solutions_ = 0;
+  const int num_vars = network_.num_variables();
+  for (int v = 0; v < num_vars; ++v) {
+    if (table_.domain(v).empty()) {
+      // Networks with empty domains have no solutions.
+      duration_ = Clock(clock_type_) - begin_clock_;
+      return false;
+    }
+  }
+
+  Assignment assignment(network_);
+  RandomAssignment(&assignment);
+  best_assignment_ = assignment;
+  best_num_violated_ = table_.num_violated_constraints();
+  int num_stalls = 0;
+  for (int iteration = 0; ; ++iteration) {
+    if (iteration % kCheckInterval == 0 &&
+        (cancelled_ || Clock(clock_type_) - begin_clock_ > time_limit_)) {
+      // Search cancelled or time limit reached.
+      break;
+    }
+    if (max_num_steps_ && num_steps_ >= max_num_steps_) {
+      // Step limit reached.
+      break;
+    }
+    if (!table_.num_violated_constraints()) {
+      // Solution found.
+      assert(assignment.Consistent());
+      AddSolution(assignment, &solutions_);
+      if (num_solutions_ >= max_num_solutions_) {
+        break;
+      }
+    }
+    int variable = 0;
+    int value = 0;
+    if ((stall_limit_ && num_stalls >= stall_limit_) ||
+        !SelectMove(&variable, &value)) {
+      // Restart from a random assignment, also after a solution was found.
+      ++num_restarts_;
+      RandomAssignment(&assignment);
+      num_stalls = 0;
+      continue;
+    }
+    ++num_steps_;
+    // The left value stays tabu for a random tenure.
+    tabu_[variable][table_.value(variable)] =
+      num_steps_ + tabu_tenure_ + random_gen_.Next() * (tabu_tenure_ + 1);
+    table_.Flip(variable, value);
+    assignment.Reassign(variable, value);
+    const int num_violated = table_.num_violated_constraints();
+    if (num_violated < best_num_violated_) {
+      best_num_violated_ = num_violated;
+      best_assignment_ = assignment;
+      num_stalls = 0;
+    } else {
+      ++num_stalls;
+    }
+  }
+
+  duration_ = Clock(clock_type_) - begin_clock_;
+  return num_solutions_;
+}
+
+bool TabuSolver::complete() const {
+  return false;
+}
+
+bool TabuSolver::SelectMove(int* variable, int* value) {
+  int best_score = numeric_limits<int>::max();
+  int num_ties = 0;
+  // Each step uses a unique mark for the evaluated variables.
+  const int mark = num_steps_ + num_restarts_ + 1;
+  const vector<int>& violated = table_.violated_constraints();
+  for (auto it = violated.cbegin(), end = violated.cend(); it != end; ++it) {
+    const Constraint& constraint = network_.constraint(*it);
+    const int arity = constraint.arity();
+    for (int i = 0; i < arity; ++i) {
+      const int var_id = constraint.scope(i);
+      if (var_marks_[var_id] == mark) {
+        continue;
+      }
+      var_marks_[var_id] = mark;
+      const int current = table_.value(var_id);
+      const vector<int>& domain = table_.domain(var_id);
+      const vector<int>& tabu = tabu_[var_id];
+      for (auto it2 = domain.cbegin(), end2 = domain.cend();
+           it2 != end2; ++it2) {
+        const int val = *it2;
+        if (val == current) {
+          continue;
+        }
+        const int score = table_.Score(var_id, val);
+        if (tabu[val] > num_steps_ && score >= best_num_violated_) {
+          // Tabu move without aspiration.
+          continue;
+        }
+        if (score < best_score) {
+          best_score = score;
+          num_ties = 1;
+          *variable = var_id;
+          *value = val;
+        } else if (score == best_score &&
+                   random_gen_.Next() * ++num_ties < 1.0f) {
+          // Uniform selection among equally good moves.
+          *variable = var_id;
+          *value = val;
+        }
+      }
+    }
+  }
+  return num_ties;
+}
+
+void TabuSolver::RandomAssignment(Assignment* assignment) {
+  const int num_vars = network_.num_variables();
+  for (int v = 0; v < num_vars; ++v) {
+    const vector<int>& domain = table_.domain(v);
+    const int value = domain[random_gen_.Next() * domain.size()];
+    if (assignment->Assigned(v)) {
+      assignment->Reassign(v, value);
+    } else {
+      assignment->Assign(v, value);
+    }
+  }
+  table_.Init(*assignment);
+  for (auto it = tabu_.begin(), end = tabu_.end(); it != end; ++it) {
+    fill(it->begin(), it->end(), 0);
+  }
+}
+
+void TabuSolver::Reset() {
+  duration_ = 0;
+  best_num_violated_ = network_.num_constraints();
+  num_steps_ = 0;
+  num_restarts_ = 0;
+  fill(var_marks_.begin(), var_marks_.end(), 0);
+}
+
+void TabuSolver::tabu_tenure(const int tenure) {
+  tabu_tenure_ = max(0, tenure);
+}
+
+int TabuSolver::tabu_tenure() const {
+  return tabu_tenure_;
+}
+
+void TabuSolver::stall_limit(const int num) {
+  stall_limit_ = max(0, num);
+}
+
+int TabuSolver::stall_limit() const {
+  return stall_limit_;
+}
+
+void TabuSolver::max_num_steps(const int num) {
+  max_num_steps_ = max(0, num);
+}
+
+int TabuSolver::max_num_steps() const {
+  return max_num_steps_;
+}
+
+void TabuSolver::seed(const uint32_t seed) {
+  random_gen_ = RandomGenerator<float>(seed);
+}
+
+void TabuSolver::time_limit(const Clock::Diff& limit) {
+  time_limit_ = min(limit, Solver::kDefTimeLimit);
+}
+
+Clock::Diff TabuSolver::time_limit() const {
+  return time_limit_;
+}
+
+void TabuSolver::max_num_solutions(const int num) {
+  max_num_solutions_ = num > 0 ? num : Solver::kDefMaxNumSolutions;
+}
+
+int TabuSolver::max_num_solutions() const {
+  return max_num_solutions_;
+}
+
+const vector<Assignment>& TabuSolver::solutions() const {
+  return solutions_;
+}
+
+const Assignment& TabuSolver::best_assignment() const {
+  return best_assignment_;
+}
+
+int TabuSolver::best_num_violated() const {
+  return best_num_violated_;
+}
+
+int TabuSolver::num_steps() const {
+  return num_steps_;
+}
+
+int TabuSolver::num_restarts() const {
+  return num_restarts_;
+}
+
+int TabuSolver::num_backtracks() const {
+  return 0;
+}
+
+double TabuSolver::num_explored_states() const {
+  return num_steps_;
+}
+
+Clock::Diff TabuSolver::duration() const {
+  return duration_;
+}
+
+}  // namespace ace
@@ -0,0 +1,137 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#ifndef SRC_TABU_SOLVER_H_
+#define SRC_TABU_SOLVER_H_
+
+#include <vector>
+#include "./solver.h"
+#include "./clock.h"
+#include "./random.h"
+#include "./assignment.h"
+#include "./conflict-table.h"
+
+namespace ace {
+
+// The constraint network.
+class Network;
+
+// A constraint network solver based on tabu search with the min-conflicts
+// heuristic. In each step it changes the value of a variable in a violated
+// constraint to the value with the fewest resulting violations. Reassigning a
+// variable to a value it just left is tabu for a number of steps, unless the
+// move leads to a new best assignment (aspiration). The search is incomplete.
+class TabuSolver : public Solver {
+ public:
+  static const int kDefTabuTenure;
+  static const int kDefStallLimit;
+  static const uint32_t kDefSeed;
+
+  // Initialises the solver with the given network.
+  explicit TabuSolver(Network* network);
+
+  // Searches for a solution for the network.
+  // Returns whether it found a solution.
+  bool Solve();
+
+  // Returns false, the search can only prove satisfiability.
+  bool complete() const;
+
+  // Resets the solver meta-information, which is collected during search.
+  void Reset();
+
+  // Sets the number of steps a left value remains tabu for its variable. The
+  // actual tenure is randomly chosen between the set tenure and twice of it.
+  void tabu_tenure(const int tenure);
+
+  // Returns the set tabu tenure.
+  int tabu_tenure() const;
+
+  // Sets the number of steps without improvement of the best assignment,
+  // after which the search restarts from a random assignment (0 for no
+  // restarts).
+  void stall_limit(const int num);
+
+  // Returns the set number of steps without improvement before restarts.
+  int stall_limit() const;
+
+  // Sets the maximum number of steps, after which the search stops (0 for
+  // unlimited steps).
+  void max_num_steps(const int num);
+
+  // Returns the set maximum number of steps.
+  int max_num_steps() const;
+
+  // Sets the seed of the random generator.
+  void seed(const uint32_t seed);
+
+  // Sets the time limit for the search. Search will be terminated if the time
+  // limit is exceeded, returning false.
+  void time_limit(const base::Clock::Diff& limit);
+
+  // Returns the set time limit.
+  base::Clock::Diff time_limit() const;
+
+  // Sets the maximum number of solutions to be searched for.
+  void max_num_solutions(const int num);
+
+  // Returns the set maximum number of solutions to be searched for.
+  int max_num_solutions() const;
+
+  // Returns a const reference to the solutions found by the last search.
+  const std::vector<Assignment>& solutions() const;
+
+  // Returns the duration of the last search in microseconds.
+  base::Clock::Diff duration() const;
+
+  // Returns the best assignment found during the last search, which has the
+  // fewest violated constraints.
+  const Assignment& best_assignment() const;
+
+  // Returns the number of violated constraints of the best assignment.
+  int best_num_violated() const;
+
+  // Returns the number of steps during the last search.
+  int num_steps() const;
+
+  // Returns the number of restarts during the last search.
+  int num_restarts() const;
+
+  // Returns the number of backtracks used during the last search.
+  int num_backtracks() const;
+
+  // Returns the number of states explored during the last search.
+  double num_explored_states() const;
+
+ private:
+  // Assigns random values to all variables.
+  void RandomAssignment(Assignment* assignment);
+
+  // Selects the best non-tabu move among the variables of the violated
+  // constraints. Tabu moves are only selected if they improve the best
+  // assignment.
+  // Returns false if no move is allowed.
+  bool SelectMove(int* variable, int* value);
+
+  Network& network_;
+  ConflictTable table_;
+  Assignment best_assignment_;
+  std::vector<Assignment> solutions_;
+  // The step until which the variable-value pair is tabu, indexed by variable
+  // and value.
+  std::vector<std::vector<int> > tabu_;
+  // Marks the variables already evaluated during the move selection.
+  std::vector<int> var_marks_;
+  int best_num_violated_;
+  int num_steps_;
+  int num_restarts_;
+  int tabu_tenure_;
+  int stall_limit_;
+  int max_num_steps_;
+  base::Clock begin_clock_;
+  base::Clock::Diff duration_;
+  base::Clock::Diff time_limit_;
+  size_t max_num_solutions_;
+  base::RandomGenerator<float> random_gen_;
+};
+
+}  // namespace ace
+#endif  // SRC_TABU_SOLVER_H_
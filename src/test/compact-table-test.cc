@@ -0,0 +1,162 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <string>
+#include <vector>
+#include <set>
+#include "../compact-table.h"
+#include "../network.h"
+
+using ace::CompactTable;
+using ace::TupleTable;
+using ace::Network;
+using ace::Domain;
+using ace::Variable;
+
+using std::vector;
+using std::set;
+using std::to_string;
+
+using ::testing::ElementsAre;
+
+class CompactTableTest : public ::testing::Test {
+ public:
+  void SetUp() {
+    const int domain_id = network.AddDomain(Domain("D0", {1, 2, 3}));
+    for (int i = 0; i < 3; ++i) {
+      network.AddVariable(Variable("v" + to_string(i), domain_id,
+                                   set<int>({1, 2, 3})));
+    }
+    scope = {0, 1, 2};
+    domain_sizes = {3, 3, 3};
+    // The second variable has no support for value id 2.
+    tuples = TupleTable(3);
+    tuples.Insert({0, 1, 2});
+    tuples.Insert({1, 1, 1});
+    tuples.Insert({2, 0, 1});
+    tuples.Insert({0, 0, 0});
+  }
+
+  // Starts a transaction on the network and the table.
+  void StartTransaction(CompactTable* table) {
+    network.StartTransaction();
+    table->StartTransaction();
+  }
+
+  // Rolls back the transaction on the network and the table.
+  void RollbackTransaction(CompactTable* table) {
+    network.RollbackTransaction();
+    table->RollbackTransaction();
+  }
+
+  Network network;
+  vector<int> scope;
+  vector<int> domain_sizes;
+  TupleTable tuples;
+};
+
+TEST_F(CompactTableTest, Supports) {
+  CompactTable table(domain_sizes, tuples, false);
+  EXPECT_EQ(4, table.num_tuples());
+  EXPECT_TRUE(table.Supports({0, 1, 2}));
+  EXPECT_TRUE(table.Supports({2, 0, 1}));
+  EXPECT_FALSE(table.Supports({1, 0, 2}));
+  EXPECT_FALSE(table.Supports({2, 2, 2}));
+}
+
+TEST_F(CompactTableTest, Propagate) {
+  CompactTable table(domain_sizes, tuples, false);
+  vector<int> reduced;
+  EXPECT_TRUE(table.Propagate(scope, &network, &reduced));
+  EXPECT_THAT(reduced, ElementsAre(1));
+  EXPECT_THAT(network.variable(1).valid_value_ids(), ElementsAre(0, 1));
+  EXPECT_EQ(1, table.num_prunings());
+
+  network.variable(0).RemoveValue(0);
+  reduced.clear();
+  EXPECT_TRUE(table.Propagate(scope, &network, &reduced));
+  EXPECT_THAT(reduced, ElementsAre(2));
+  EXPECT_THAT(network.variable(2).valid_value_ids(), ElementsAre(1));
+  EXPECT_EQ(3, table.num_prunings());
+
+  network.variable(2).RemoveValue(1);
+  reduced.clear();
+  EXPECT_FALSE(table.Propagate(scope, &network, &reduced));
+}
+
+TEST_F(CompactTableTest, Rollback) {
+  CompactTable table(domain_sizes, tuples, false);
+  vector<int> reduced;
+  StartTransaction(&table);
+  network.variable(0).RemoveValue(0);
+  EXPECT_TRUE(table.Propagate(scope, &network, &reduced));
+  EXPECT_THAT(reduced, ElementsAre(1, 2));
+  EXPECT_THAT(network.variable(2).valid_value_ids(), ElementsAre(1));
+
+  StartTransaction(&table);
+  network.variable(0).RemoveValue(1);
+  network.variable(0).RemoveValue(2);
+  EXPECT_FALSE(table.Propagate(scope, &network, &reduced));
+  RollbackTransaction(&table);
+
+  // The valid tuples are restored along with the domains.
+  reduced.clear();
+  EXPECT_TRUE(table.Propagate(scope, &network, &reduced));
+  EXPECT_THAT(reduced, ElementsAre());
+  RollbackTransaction(&table);
+
+  reduced.clear();
+  EXPECT_TRUE(table.Propagate(scope, &network, &reduced));
+  EXPECT_THAT(reduced, ElementsAre(1));
+  EXPECT_THAT(network.variable(0).valid_value_ids(), ElementsAre(0, 1, 2));
+  EXPECT_THAT(network.variable(2).valid_value_ids(), ElementsAre(0, 1, 2));
+}
+
+TEST_F(CompactTableTest, Conflicts) {
+  // All combinations with value id 0 of the first variable conflict.
+  TupleTable conflicts(3);
+  for (int v1 = 0; v1 < 3; ++v1) {
+    for (int v2 = 0; v2 < 3; ++v2) {
+      conflicts.Insert({0, v1, v2});
+    }
+  }
+  conflicts.Insert({1, 2, 2});
+  CompactTable table(domain_sizes, conflicts, true);
+  EXPECT_FALSE(table.Supports({0, 1, 1}));
+  EXPECT_FALSE(table.Supports({1, 2, 2}));
+  EXPECT_TRUE(table.Supports({1, 2, 1}));
+  vector<int> reduced;
+  EXPECT_TRUE(table.Propagate(scope, &network, &reduced));
+  EXPECT_THAT(reduced, ElementsAre(0));
+  EXPECT_THAT(network.variable(0).valid_value_ids(), ElementsAre(1, 2));
+
+  StartTransaction(&table);
+  network.variable(0).RemoveValue(2);
+  network.variable(1).RemoveValue(0);
+  network.variable(1).RemoveValue(1);
+  reduced.clear();
+  EXPECT_TRUE(table.Propagate(scope, &network, &reduced));
+  EXPECT_THAT(reduced, ElementsAre(2));
+  EXPECT_THAT(network.variable(2).valid_value_ids(), ElementsAre(0, 1));
+
+  RollbackTransaction(&table);
+
+  // The only remaining combination conflicts.
+  StartTransaction(&table);
+  network.variable(0).RemoveValue(2);
+  network.variable(1).RemoveValue(0);
+  network.variable(1).RemoveValue(1);
+  network.variable(2).RemoveValue(0);
+  network.variable(2).RemoveValue(1);
+  reduced.clear();
+  EXPECT_FALSE(table.Propagate(scope, &network, &reduced));
+  RollbackTransaction(&table);
+
+  // No conflicting tuple remains valid, the constraint is entailed.
+  StartTransaction(&table);
+  network.variable(1).RemoveValue(2);
+  reduced.clear();
+  EXPECT_TRUE(table.Propagate(scope, &network, &reduced));
+  EXPECT_THAT(reduced, ElementsAre());
+  RollbackTransaction(&table);
+}
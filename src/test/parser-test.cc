@@ -150,6 +150,64 @@ TEST_F(ParserTest, CollectIntValues) {
   }
 }
 
+TEST_F(ParserTest, CollectIntTuples) {
+  {
+    Relation::TupleSet tuples;
+    EXPECT_TRUE(Parser::CollectIntTuples(&tuples, ""));
+    EXPECT_TRUE(tuples.empty());
+  }
+  {
+    Relation::TupleSet tuples;
+    EXPECT_TRUE(Parser::CollectIntTuples(&tuples, " 1 3 | 1 4|2 4 "));
+    EXPECT_EQ(3u, tuples.size());
+    EXPECT_TRUE(tuples.Contains({1, 3}));
+    EXPECT_TRUE(tuples.Contains({1, 4}));
+    EXPECT_TRUE(tuples.Contains({2, 4}));
+  }
+  {
+    Relation::TupleSet tuples;
+    EXPECT_TRUE(Parser::CollectIntTuples(&tuples, "-1 3 | 1 -4 | -2 -40"));
+    EXPECT_EQ(3u, tuples.size());
+    EXPECT_TRUE(tuples.Contains({-1, 3}));
+    EXPECT_TRUE(tuples.Contains({1, -4}));
+    EXPECT_TRUE(tuples.Contains({-2, -40}));
+    EXPECT_FALSE(tuples.Contains({1, 3}));
+  }
+  {
+    const int any = ace::TupleTable::kAny;
+    Relation::TupleSet tuples;
+    EXPECT_TRUE(Parser::CollectIntTuples(&tuples, "* 1 * | 2 * -3 | 1 2 3"));
+    EXPECT_EQ(3u, tuples.size());
+    EXPECT_TRUE(tuples.Contains({any, 1, any}));
+    EXPECT_TRUE(tuples.Contains({2, any, -3}));
+    EXPECT_TRUE(tuples.Matches({7, 1, 7}));
+    EXPECT_TRUE(tuples.Matches({2, 9, -3}));
+    EXPECT_TRUE(tuples.Matches({1, 2, 3}));
+    EXPECT_FALSE(tuples.Matches({2, 9, 3}));
+    EXPECT_FALSE(tuples.Matches({1, 2, 4}));
+  }
+  {
+    string tuple_str(64 * 2, ' ');
+    for (int i = 0; i < 64; ++i) {
+      tuple_str[2 * i] = i % 2 ? '*' : '1';
+    }
+    Relation::TupleSet tuples;
+    EXPECT_TRUE(Parser::CollectIntTuples(&tuples, tuple_str));
+    EXPECT_EQ(1u, tuples.size());
+    Relation::TupleSet wide_tuples;
+    EXPECT_FALSE(Parser::CollectIntTuples(&wide_tuples, tuple_str + "*"));
+    EXPECT_TRUE(wide_tuples.empty());
+    // Wide tuples without wildcards are unrestricted.
+    string wide_str;
+    for (int i = 0; i < 100; ++i) {
+      wide_str += "1 ";
+    }
+    EXPECT_TRUE(Parser::CollectIntTuples(&wide_tuples, wide_str));
+    EXPECT_EQ(1u, wide_tuples.size());
+    EXPECT_EQ(100, wide_tuples.arity());
+  }
+}
+
 TEST_F(ParserTest, Split) {
   {
     string s = "";
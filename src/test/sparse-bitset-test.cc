@@ -0,0 +1,91 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <cstdint>
+#include <vector>
+#include "../sparse-bitset.h"
+
+using ace::SparseBitset;
+
+using std::vector;
+
+// Intersects the bitset with given bits.
+void Intersect(const vector<uint64_t>& bits, SparseBitset* bitset) {
+  bitset->ClearMask();
+  bitset->AddToMask(bits);
+  bitset->IntersectWithMask();
+}
+
+TEST(SparseBitsetTest, Init) {
+  SparseBitset bitset(130);
+  EXPECT_EQ(3, bitset.num_words());
+  EXPECT_FALSE(bitset.empty());
+  EXPECT_EQ(~uint64_t(0), bitset.word(0));
+  EXPECT_EQ(~uint64_t(0), bitset.word(1));
+  EXPECT_EQ(uint64_t(3), bitset.word(2));
+  EXPECT_TRUE(SparseBitset(0).empty());
+}
+
+TEST(SparseBitsetTest, Intersect) {
+  SparseBitset bitset(130);
+  bitset.ClearMask();
+  bitset.AddToMask({0xF0, 0, 0});
+  bitset.AddToMask({0x0F, 0, 1});
+  bitset.IntersectWithMask();
+  EXPECT_FALSE(bitset.empty());
+  EXPECT_EQ(uint64_t(0xFF), bitset.word(0));
+  EXPECT_EQ(uint64_t(0), bitset.word(1));
+  EXPECT_EQ(uint64_t(1), bitset.word(2));
+  EXPECT_EQ(-1, bitset.IntersectIndex({0xF00, ~uint64_t(0), 2}));
+  EXPECT_EQ(2, bitset.IntersectIndex({0xF00, ~uint64_t(0), 1}));
+  EXPECT_EQ(0, bitset.IntersectIndex({0x1, 0, 1}));
+  EXPECT_EQ(uint64_t(0), bitset.IntersectCount({0xF00, ~uint64_t(0), 2}));
+  EXPECT_EQ(uint64_t(5), bitset.IntersectCount({0xF0F, ~uint64_t(0), 3}));
+  Intersect({0x100, ~uint64_t(0), 2}, &bitset);
+  EXPECT_TRUE(bitset.empty());
+}
+
+TEST(SparseBitsetTest, Rollback) {
+  SparseBitset bitset(130);
+  bitset.StartTransaction();
+  Intersect({0xFF, 0, 3}, &bitset);
+  bitset.StartTransaction();
+  Intersect({0x0F, 0, 0}, &bitset);
+  EXPECT_EQ(uint64_t(0x0F), bitset.word(0));
+  EXPECT_EQ(-1, bitset.IntersectIndex({0, 0, 3}));
+  bitset.StartTransaction();
+  Intersect({0xF0, 0, 0}, &bitset);
+  EXPECT_TRUE(bitset.empty());
+  bitset.RollbackTransaction();
+  EXPECT_FALSE(bitset.empty());
+  EXPECT_EQ(uint64_t(0x0F), bitset.word(0));
+  bitset.RollbackTransaction();
+  EXPECT_EQ(uint64_t(0xFF), bitset.word(0));
+  EXPECT_EQ(uint64_t(0), bitset.word(1));
+  EXPECT_EQ(uint64_t(3), bitset.word(2));
+  EXPECT_EQ(2, bitset.IntersectIndex({0, 0, 3}));
+  bitset.RollbackTransaction();
+  EXPECT_EQ(~uint64_t(0), bitset.word(0));
+  EXPECT_EQ(~uint64_t(0), bitset.word(1));
+  EXPECT_EQ(uint64_t(3), bitset.word(2));
+  EXPECT_EQ(1, bitset.IntersectIndex({0, 1, 0}));
+}
+
+TEST(SparseBitsetTest, Commit) {
+  SparseBitset bitset(130);
+  bitset.StartTransaction();
+  bitset.StartTransaction();
+  Intersect({0xFF, 0, 3}, &bitset);
+  bitset.CommitTransaction();
+  bitset.StartTransaction();
+  Intersect({0, 0, 0}, &bitset);
+  EXPECT_TRUE(bitset.empty());
+  bitset.RollbackTransaction();
+  EXPECT_EQ(uint64_t(0xFF), bitset.word(0));
+  EXPECT_EQ(uint64_t(0), bitset.word(1));
+  EXPECT_EQ(uint64_t(3), bitset.word(2));
+  // Like variable domains, committed modifications are irreversable.
+  bitset.RollbackTransaction();
+  EXPECT_EQ(uint64_t(0xFF), bitset.word(0));
+  EXPECT_EQ(uint64_t(0), bitset.word(1));
+}
@@ -0,0 +1,104 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <vector>
+#include <set>
+#include "../tuple-table.h"
+#include "../random.h"
+
+using ace::TupleTable;
+using base::RandomGenerator;
+
+using std::vector;
+using std::set;
+
+using ::testing::ElementsAre;
+
+// Returns the tuples of the table in lexicographical order.
+set<vector<int> > Tuples(const TupleTable& table) {
+  set<vector<int> > tuples;
+  for (size_t i = 0, size = table.size(); i < size; ++i) {
+    const int* tuple = table.tuple(i);
+    tuples.insert(vector<int>(tuple, tuple + table.arity()));
+  }
+  return tuples;
+}
+
+TEST(TupleTableTest, Insert) {
+  TupleTable table;
+  EXPECT_TRUE(table.empty());
+  EXPECT_EQ(0, table.arity());
+  EXPECT_TRUE(table.Insert({1, 3}));
+  EXPECT_EQ(2, table.arity());
+  EXPECT_TRUE(table.Insert({3, 1}));
+  EXPECT_FALSE(table.Insert({1, 3}));
+  EXPECT_EQ(2u, table.size());
+  EXPECT_THAT(vector<int>(table.tuple(0), table.tuple(0) + 2),
+              ElementsAre(1, 3));
+  EXPECT_THAT(vector<int>(table.tuple(1), table.tuple(1) + 2),
+              ElementsAre(3, 1));
+  EXPECT_TRUE(table.Contains({1, 3}));
+  EXPECT_TRUE(table.Contains({3, 1}));
+  EXPECT_FALSE(table.Contains({1, 1}));
+  EXPECT_FALSE(table.Contains({3, 3}));
+}
+
+TEST(TupleTableTest, Erase) {
+  TupleTable table(3);
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_TRUE(table.Insert({i, i + 1, i + 2}));
+  }
+  // The last tuple is moved into the place of the erased one.
+  EXPECT_TRUE(table.Erase({0, 1, 2}));
+  EXPECT_FALSE(table.Erase({0, 1, 2}));
+  EXPECT_EQ(99u, table.size());
+  EXPECT_THAT(vector<int>(table.tuple(0), table.tuple(0) + 3),
+              ElementsAre(99, 100, 101));
+  EXPECT_FALSE(table.Contains({0, 1, 2}));
+  for (int i = 1; i < 100; ++i) {
+    EXPECT_TRUE(table.Contains({i, i + 1, i + 2}));
+  }
+  // Erasing the last tuple.
+  EXPECT_TRUE(table.Erase({98, 99, 100}));
+  EXPECT_EQ(98u, table.size());
+  for (int i = 1; i < 100; ++i) {
+    EXPECT_EQ(i != 98, table.Contains({i, i + 1, i + 2}));
+  }
+  for (int i = 1; i < 100; ++i) {
+    table.Erase({i, i + 1, i + 2});
+  }
+  EXPECT_TRUE(table.empty());
+  EXPECT_TRUE(table.Insert({1, 2, 3}));
+  EXPECT_TRUE(table.Contains({1, 2, 3}));
+}
+
+TEST(TupleTableTest, Random) {
+  // Small value ranges cause long probe sequences and many collisions, which
+  // exercises the backward shifting on erasure.
+  RandomGenerator<double> random(42);
+  for (int round = 0; round < 10; ++round) {
+    const int range = 2 + round;
+    TupleTable table(2);
+    set<vector<int> > expected;
+    if (round % 2) {
+      table.Reserve(range * range);
+    }
+    for (int i = 0; i < 2000; ++i) {
+      const vector<int> values({static_cast<int>(random.Next() * range),
+                                static_cast<int>(random.Next() * range)});
+      if (random.Next() < 0.6) {
+        EXPECT_EQ(expected.insert(values).second, table.Insert(values));
+      } else {
+        EXPECT_EQ(expected.erase(values) == 1, table.Erase(values));
+      }
+      ASSERT_EQ(expected.size(), table.size());
+    }
+    EXPECT_EQ(expected, Tuples(table));
+    for (int v1 = 0; v1 < range; ++v1) {
+      for (int v2 = 0; v2 < range; ++v2) {
+        const vector<int> values({v1, v2});
+        EXPECT_EQ(expected.count(values) == 1, table.Contains(values));
+      }
+    }
+  }
+}
@@ -4,11 +4,17 @@
 #include <fstream>
 #include <vector>
 #include <set>
+#include <string>
+#include <algorithm>
 #include "../parser.h"
 #include "../network.h"
 #include "../network-factory.h"
 #include "../min-width-ordering.h"
 #include "../max-cardinality-ordering.h"
+#include "../min-fill-ordering.h"
+#include "../best-ordering.h"
+#include "../random.h"
+#include "../clock.h"
 
 using std::vector;
 using std::set;
@@ -16,11 +22,19 @@ using std::string;
 using std::cout;
 using std::endl;
 using std::ofstream;
+using std::to_string;
+using std::sort;
 
 using ace::parse::Parser;
 using ace::parse::Instance;
 using ace::Network;
 using ace::NetworkFactory;
+using ace::Domain;
+using ace::Variable;
+using ace::Relation;
+using ace::Constraint;
+using base::Clock;
+using base::RandomGenerator;
 
 using ::testing::ElementsAre;
 using ::testing::Contains;
@@ -118,3 +132,105 @@ TEST_F(VariableOrderingTest, MaxCardinality) {
   vector<int> expected({0, 1, 2, 4, 3, 5, 7, 6, 8});
   EXPECT_EQ(expected, ordering.CreateOrdering());
 }
+
+TEST_F(VariableOrderingTest, MinFill) {
+  using ace::MinFillOrdering;
+  MinFillOrdering ordering(network);
+  vector<int> expected({7, 6, 3, 4, 0, 1, 8, 2, 5});
+  EXPECT_EQ(expected, ordering.CreateOrdering());
+}
+
+TEST_F(VariableOrderingTest, InducedWidth) {
+  using ace::VariableOrdering;
+  using ace::MinWidthOrdering;
+  using ace::MaxCardinalityOrdering;
+  using ace::MinFillOrdering;
+  using ace::BestOrdering;
+  vector<int> lexicographic({0, 1, 2, 3, 4, 5, 6, 7, 8});
+  EXPECT_EQ(4, VariableOrdering::InducedWidth(network, lexicographic));
+  EXPECT_EQ(3, VariableOrdering::InducedWidth(network,
+    MinWidthOrdering(network).CreateOrdering()));
+  EXPECT_EQ(3, VariableOrdering::InducedWidth(network,
+    MaxCardinalityOrdering(network).CreateOrdering()));
+  EXPECT_EQ(3, VariableOrdering::InducedWidth(network,
+    MinFillOrdering(network).CreateOrdering()));
+  EXPECT_EQ(3, VariableOrdering::InducedWidth(network,
+    BestOrdering(network).CreateOrdering()));
+}
+
+// Creates a random binary network with given number of variables and
+// constraints, without finalising it.
+void CreateRandomNetwork(const int num_vars, const int num_cons,
+                         Network* network) {
+  const int domain_id = network->AddDomain(Domain("D0", {1}));
+  const set<int> domain({0});
+  for (int i = 0; i < num_vars; ++i) {
+    network->AddVariable(Variable("v" + to_string(i), domain_id, domain));
+  }
+  const int relation_id = network->AddRelation(
+    Relation("r0", Relation::kConflicts, Relation::TupleSet()));
+  RandomGenerator<double> random(42);
+  for (int i = 0; i < num_cons; ++i) {
+    const int var1 = random.Next() * num_vars;
+    int var2 = random.Next() * (num_vars - 1);
+    var2 += var2 >= var1;
+    network->AddConstraint(Constraint("c" + to_string(i), relation_id,
+                                      {var1, var2}, *network));
+  }
+}
+
+// Checks that the orderings are permutations on random networks.
+TEST(VariableOrderingRandomTest, RandomNetworks) {
+  using ace::MinWidthOrdering;
+  using ace::MaxCardinalityOrdering;
+  for (int num_cons = 100; num_cons <= 10000; num_cons *= 10) {
+    const int num_vars = num_cons / 10;
+    Network network;
+    CreateRandomNetwork(num_vars, num_cons, &network);
+    vector<int> identity(num_vars);
+    for (int i = 0; i < num_vars; ++i) {
+      identity[i] = i;
+    }
+
+    vector<int> ordering = MinWidthOrdering(network).CreateOrdering();
+    sort(ordering.begin(), ordering.end());
+    EXPECT_EQ(identity, ordering);
+
+    ordering = MaxCardinalityOrdering(network).CreateOrdering();
+    sort(ordering.begin(), ordering.end());
+    EXPECT_EQ(identity, ordering);
+  }
+}
+
+// Times the orderings on random networks with up to 10^6 constraints, run with
+// --gtest_also_run_disabled_tests.
+TEST(VariableOrderingBenchmark, DISABLED_RandomNetworks) {
+  using ace::MinWidthOrdering;
+  using ace::MaxCardinalityOrdering;
+  for (int num_cons = 10000; num_cons <= 1000000; num_cons *= 10) {
+    const int num_vars = num_cons / 10;
+    Network network;
+    CreateRandomNetwork(num_vars, num_cons, &network);
+    vector<int> identity(num_vars);
+    for (int i = 0; i < num_vars; ++i) {
+      identity[i] = i;
+    }
+
+    Clock beg;
+    vector<int> ordering = MinWidthOrdering(network).CreateOrdering();
+    const Clock::Diff min_width_duration = Clock() - beg;
+    sort(ordering.begin(), ordering.end());
+    EXPECT_EQ(identity, ordering);
+
+    beg = Clock();
+    ordering = MaxCardinalityOrdering(network).CreateOrdering();
+    const Clock::Diff max_cardinality_duration = Clock() - beg;
+    sort(ordering.begin(), ordering.end());
+    EXPECT_EQ(identity, ordering);
+
+    cout << "Constraints: " << num_cons
+         << ", MinWidth: " << Clock::DiffStr(min_width_duration)
+         << ", MaxCardinality: " << Clock::DiffStr(max_cardinality_duration)
+         << endl;
+  }
+}
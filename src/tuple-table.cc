@@ -0,0 +1,198 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include "./tuple-table.h"
+#include <cassert>
+#include <algorithm>
+#include <vector>
+
+using std::vector;
+using std::copy;
+using std::equal;
+using std::make_pair;
+
+namespace ace {
+
+const int TupleTable::kAny;
+const int TupleTable::kMaxWildcardArity;
+
+// The minimum capacity of the index.
+static const size_t kMinCapacity = 8;
+
+TupleTable::TupleTable(const int arity)
+    : arity_(arity),
+      slots_(kMinCapacity, 0),
+      mask_(kMinCapacity - 1) {}
+
+bool TupleTable::Insert(const vector<int>& values) {
+  if (arity_ == 0) {
+    arity_ = values.size();
+  }
+  assert(static_cast<int>(values.size()) == arity_);
+  const size_t slot = Find(values.data());
+  if (slots_[slot]) {
+    return false;
+  }
+  values_.insert(values_.end(), values.begin(), values.end());
+  slots_[slot] = size();
+  const uint64_t pattern = Pattern(values.data());
+  auto it = patterns_.begin();
+  while (it != patterns_.end() && it->first != pattern) {
+    ++it;
+  }
+  if (it == patterns_.end()) {
+    patterns_.push_back(make_pair(pattern, size_t(1)));
+  } else {
+    ++it->second;
+  }
+  if (2 * size() > slots_.size()) {
+    // Keep the load factor below 1/2.
+    Rehash(2 * slots_.size());
+  }
+  return true;
+}
+
+bool TupleTable::Erase(const vector<int>& values) {
+  if (empty()) {
+    return false;
+  }
+  assert(static_cast<int>(values.size()) == arity_);
+  size_t slot = Find(values.data());
+  if (!slots_[slot]) {
+    return false;
+  }
+  const uint64_t pattern = Pattern(values.data());
+  for (auto it = patterns_.begin(), end = patterns_.end(); it != end; ++it) {
+    if (it->first == pattern) {
+      if (--it->second == 0) {
+        patterns_.erase(it);
+      }
+      break;
+    }
+  }
+  const size_t index = slots_[slot] - 1;
+  const size_t last = size() - 1;
+  if (index != last) {
+    // Move the last tuple into the place of the erased one.
+    const int* last_values = tuple(last);
+    slots_[Find(last_values)] = index + 1;
+    copy(last_values, last_values + arity_, values_.begin() + index * arity_);
+  }
+  values_.resize(last * arity_);
+  // Shift the following slots of the probing sequence back.
+  size_t next = (slot + 1) & mask_;
+  while (slots_[next]) {
+    const size_t home = Hash(tuple(slots_[next] - 1)) & mask_;
+    if (((next - home) & mask_) >= ((next - slot) & mask_)) {
+      slots_[slot] = slots_[next];
+      slot = next;
+    }
+    next = (next + 1) & mask_;
+  }
+  slots_[slot] = 0;
+  return true;
+}
+
+bool TupleTable::Contains(const vector<int>& values) const {
+  if (static_cast<int>(values.size()) != arity_) {
+    return false;
+  }
+  return slots_[Find(values.data())];
+}
+
+bool TupleTable::Matches(const vector<int>& values) const {
+  if (!wildcards()) {
+    return Contains(values);
+  }
+  if (static_cast<int>(values.size()) != arity_) {
+    return false;
+  }
+  // Look up the values with the wildcards of each pattern.
+  int key[kMaxWildcardArity];
+  for (auto it = patterns_.cbegin(), end = patterns_.cend(); it != end; ++it) {
+    const uint64_t pattern = it->first;
+    for (int i = 0; i < arity_; ++i) {
+      key[i] = pattern >> i & 1 ? kAny : values[i];
+    }
+    if (slots_[Find(key)]) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void TupleTable::Reserve(const size_t num_tuples) {
+  values_.reserve(num_tuples * arity_);
+  size_t capacity = slots_.size();
+  while (capacity < 2 * num_tuples) {
+    capacity *= 2;
+  }
+  if (capacity > slots_.size()) {
+    Rehash(capacity);
+  }
+}
+
+size_t TupleTable::Hash(const int* values) const {
+  uint64_t h = 0xcbf29ce484222325ull;
+  for (int i = 0; i < arity_; ++i) {
+    h = (h ^ static_cast<uint32_t>(values[i])) * 0x100000001b3ull;
+    h ^= h >> 29;
+  }
+  return h;
+}
+
+size_t TupleTable::Find(const int* values) const {
+  size_t slot = Hash(values) & mask_;
+  while (slots_[slot] &&
+         !equal(values, values + arity_, tuple(slots_[slot] - 1))) {
+    slot = (slot + 1) & mask_;
+  }
+  return slot;
+}
+
+uint64_t TupleTable::Pattern(const int* values) const {
+  uint64_t pattern = 0;
+  for (int i = 0; i < arity_; ++i) {
+    if (values[i] == kAny) {
+      assert(arity_ <= kMaxWildcardArity);
+      pattern |= uint64_t(1) << i;
+    }
+  }
+  return pattern;
+}
+
+void TupleTable::Rehash(const size_t capacity) {
+  assert((capacity & (capacity - 1)) == 0);
+  slots_.assign(capacity, 0);
+  mask_ = capacity - 1;
+  const size_t num_tuples = size();
+  for (size_t i = 0; i < num_tuples; ++i) {
+    size_t slot = Hash(tuple(i)) & mask_;
+    while (slots_[slot]) {
+      slot = (slot + 1) & mask_;
+    }
+    slots_[slot] = i + 1;
+  }
+}
+
+const int* TupleTable::tuple(const size_t index) const {
+  assert(index < size());
+  return values_.data() + index * arity_;
+}
+
+int TupleTable::arity() const {
+  return arity_;
+}
+
+size_t TupleTable::size() const {
+  return arity_ ? values_.size() / arity_ : 0;
+}
+
+bool TupleTable::empty() const {
+  return values_.empty();
+}
+
+bool TupleTable::wildcards() const {
+  return patterns_.size() > 1 ||
+         (patterns_.size() == 1 && patterns_.front().first != 0);
+}
+
+}  // namespace ace
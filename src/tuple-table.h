@@ -0,0 +1,88 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#ifndef SRC_TUPLE_TABLE_H_
+#define SRC_TUPLE_TABLE_H_
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace ace {
+
+// A set of fixed-arity tuples. The tuples are packed contiguously in one array
+// in order of insertion and indexed by an open-addressing hash table with
+// linear probing, which avoids an allocation per tuple. Tuples may contain the
+// wildcard kAny, which matches any value.
+class TupleTable {
+ public:
+  // The wildcard value.
+  static const int kAny = INT_MIN;
+
+  // The maximum arity of tuples with wildcards.
+  static const int kMaxWildcardArity = 64;
+
+  // Initialises the empty table for tuples of given arity. An arity of 0 is
+  // set by the first inserted tuple.
+  explicit TupleTable(const int arity = 0);
+
+  // Inserts the tuple.
+  // Returns false if the tuple is already contained.
+  bool Insert(const std::vector<int>& values);
+
+  // Removes the tuple, moving the last tuple into its place.
+  // Returns false if the tuple is not contained.
+  bool Erase(const std::vector<int>& values);
+
+  // Returns whether the tuple is contained.
+  bool Contains(const std::vector<int>& values) const;
+
+  // Returns whether a contained tuple matches the values, with wildcards
+  // matching any value.
+  bool Matches(const std::vector<int>& values) const;
+
+  // Reserves space for given number of tuples.
+  void Reserve(const size_t num_tuples);
+
+  // Returns a pointer to the values of the tuple at given index in
+  // [0, size()).
+  const int* tuple(const size_t index) const;
+
+  // Returns the arity of the tuples.
+  int arity() const;
+
+  // Returns the number of tuples.
+  size_t size() const;
+
+  // Returns whether the table is empty.
+  bool empty() const;
+
+  // Returns whether any tuple contains a wildcard.
+  bool wildcards() const;
+
+ private:
+  // Returns the hash of the tuple values.
+  size_t Hash(const int* values) const;
+
+  // Returns the index slot of the tuple, which is empty if the tuple is not
+  // contained.
+  size_t Find(const int* values) const;
+
+  // Resizes the index to given capacity, a power of two, and reindexes all
+  // tuples.
+  void Rehash(const size_t capacity);
+
+  // Returns the wildcard positions of the tuple as bits.
+  uint64_t Pattern(const int* values) const;
+
+  int arity_;
+  std::vector<int> values_;
+  // The slots contain the tuple index + 1, 0 for empty slots.
+  std::vector<uint32_t> slots_;
+  size_t mask_;
+  // The distinct wildcard patterns with their number of tuples.
+  std::vector<std::pair<uint64_t, size_t> > patterns_;
+};
+
+}  // namespace ace
+#endif  // SRC_TUPLE_TABLE_H_
@@ -0,0 +1,67 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include "./variable-ordering.h"
+#include <cassert>
+#include <set>
+#include <vector>
+#include <algorithm>
+#include "./network.h"
+
+using std::set;
+using std::vector;
+using std::max;
+
+namespace ace {
+
+vector<set<int> > VariableOrdering::PrimalGraph(const Network& network) {
+  vector<set<int> > graph(network.num_variables());
+  const vector<Constraint>& constraints = network.constraints();
+  for (auto it = constraints.cbegin(), end = constraints.cend();
+       it != end; ++it) {
+    const vector<int>& scope = it->scope();
+    for (auto it2 = scope.cbegin(), end2 = scope.cend(); it2 != end2; ++it2) {
+      for (auto it3 = scope.cbegin(); it3 != end2; ++it3) {
+        if (*it2 != *it3) {
+          graph[*it2].insert(*it3);
+        }
+      }
+    }
+  }
+  return graph;
+}
+
+int VariableOrdering::InducedWidth(const Network& network,
+                                   const vector<int>& ordering) {
+  const int num_variables = network.num_variables();
+  assert(static_cast<int>(ordering.size()) == num_variables);
+  vector<int> positions(num_variables, 0);
+  for (int i = 0; i < num_variables; ++i) {
+    positions[ordering[i]] = i;
+  }
+  vector<set<int> > graph = PrimalGraph(network);
+  int width = 0;
+  // Process the variables from last to first, connecting the parents (earlier
+  // neighbours) of each variable. It suffices to connect the parents to the
+  // latest parent, which passes them on to its own parents when processed.
+  for (int i = num_variables - 1; i >= 0; --i) {
+    const set<int>& neighs = graph[ordering[i]];
+    vector<int> parents;
+    int latest = -1;
+    for (auto it = neighs.cbegin(), end = neighs.cend(); it != end; ++it) {
+      if (positions[*it] < i) {
+        parents.push_back(*it);
+        if (latest == -1 || positions[*it] > positions[latest]) {
+          latest = *it;
+        }
+      }
+    }
+    width = max<int>(width, parents.size());
+    for (auto it = parents.cbegin(), end = parents.cend(); it != end; ++it) {
+      if (*it != latest) {
+        graph[latest].insert(*it);
+      }
+    }
+  }
+  return width;
+}
+
+}  // namespace ace
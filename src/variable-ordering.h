@@ -2,13 +2,24 @@
 #ifndef SRC_VARIABLE_ORDERING_H_
 #define SRC_VARIABLE_ORDERING_H_
 
+#include <set>
 #include <vector>
 #include "./clock.h"
 
 namespace ace {
 
+class Network;
+
 class VariableOrdering {
  public:
+  // Returns the adjacency sets of the primal graph of the network.
+  static std::vector<std::set<int> > PrimalGraph(const Network& network);
+
+  // Returns the induced width of the primal graph of the network along given
+  // variable ordering.
+  static int InducedWidth(const Network& network,
+                          const std::vector<int>& ordering);
+
   virtual ~VariableOrdering() {}
   virtual std::vector<int> CreateOrdering() const = 0;
 };
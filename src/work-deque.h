@@ -0,0 +1,136 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#ifndef SRC_WORK_DEQUE_H_
+#define SRC_WORK_DEQUE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace base {
+
+// A lock-free work-stealing deque (Chase-Lev). The owning thread pushes and
+// pops items at the bottom, other threads steal the oldest items at the top.
+// Items need to be trivially copyable, usually pointers.
+template<typename T>
+class WorkDeque {
+ public:
+  static const int64_t kDefCapacity = 64;
+
+  explicit WorkDeque(const int64_t capacity = kDefCapacity)
+      : top_(0),
+        bottom_(0),
+        array_(new Array(capacity)) {}
+
+  ~WorkDeque() {
+    delete array_.load(std::memory_order_relaxed);
+    for (auto it = retired_.begin(), end = retired_.end(); it != end; ++it) {
+      delete *it;
+    }
+  }
+
+  // Pushes the item at the bottom. Only called by the owner.
+  void Push(const T item) {
+    const int64_t b = bottom_.load(std::memory_order_relaxed);
+    const int64_t t = top_.load(std::memory_order_acquire);
+    Array* array = array_.load(std::memory_order_relaxed);
+    if (b - t > array->capacity - 1) {
+      array = Grow(array, t, b);
+    }
+    array->Put(b, item);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(b + 1, std::memory_order_relaxed);
+  }
+
+  // Pops the item at the bottom. Only called by the owner.
+  // Returns false if the deque is empty.
+  bool Pop(T* item) {
+    const int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+    Array* array = array_.load(std::memory_order_relaxed);
+    bottom_.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top_.load(std::memory_order_relaxed);
+    if (t > b) {
+      // Empty deque.
+      bottom_.store(b + 1, std::memory_order_relaxed);
+      return false;
+    }
+    *item = array->Get(b);
+    if (t == b) {
+      // Last item, race against stealing threads.
+      const bool won = top_.compare_exchange_strong(
+        t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+      bottom_.store(b + 1, std::memory_order_relaxed);
+      return won;
+    }
+    return true;
+  }
+
+  // Steals the item at the top. May be called by any thread.
+  // Returns false if the deque is empty or the race for the item was lost.
+  bool Steal(T* item) {
+    int64_t t = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t b = bottom_.load(std::memory_order_acquire);
+    if (t >= b) {
+      return false;
+    }
+    Array* array = array_.load(std::memory_order_acquire);
+    const T stolen = array->Get(t);
+    if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                      std::memory_order_relaxed)) {
+      return false;
+    }
+    *item = stolen;
+    return true;
+  }
+
+  // Returns the approximate number of items.
+  int64_t size() const {
+    const int64_t b = bottom_.load(std::memory_order_relaxed);
+    const int64_t t = top_.load(std::memory_order_relaxed);
+    return b > t ? b - t : 0;
+  }
+
+ private:
+  // Circular item buffer.
+  struct Array {
+    explicit Array(const int64_t capacity)
+        : capacity(capacity),
+          items(new std::atomic<T>[capacity]) {}
+
+    ~Array() {
+      delete[] items;
+    }
+
+    T Get(const int64_t index) const {
+      return items[index % capacity].load(std::memory_order_relaxed);
+    }
+
+    void Put(const int64_t index, const T item) {
+      items[index % capacity].store(item, std::memory_order_relaxed);
+    }
+
+    int64_t capacity;
+    std::atomic<T>* items;
+  };
+
+  // Doubles the capacity. The old buffer may still be read by stealing
+  // threads, it is released with the deque.
+  Array* Grow(Array* array, const int64_t top, const int64_t bottom) {
+    Array* grown = new Array(array->capacity * 2);
+    for (int64_t i = top; i < bottom; ++i) {
+      grown->Put(i, array->Get(i));
+    }
+    retired_.push_back(array);
+    array_.store(grown, std::memory_order_release);
+    return grown;
+  }
+
+  std::atomic<int64_t> top_;
+  std::atomic<int64_t> bottom_;
+  std::atomic<Array*> array_;
+  std::vector<Array*> retired_;
+};
+
+}  // namespace base
+#endif  // SRC_WORK_DEQUE_H_